@@ -0,0 +1,280 @@
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/perf_counters.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Chess;
+
+static const std::string_view POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+    "2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - - 0 22",
+};
+
+constexpr size_t POSITION_COUNT = std::size(POSITIONS);
+
+// Folded into the output, such that no benchmarked work is optimised away
+static size_t checksum = 0;
+
+struct Benchmark {
+    const char *name;
+    // Runs once over every position, returning the number of operations performed
+    std::function<size_t()> run;
+};
+
+// Nanoseconds per operation over the repetitions of a benchmark, and the hardware events counted
+// over all of them
+struct Stats {
+    double median;
+    double stddev;
+    size_t operations;
+    PerfCounts counts;
+};
+
+// Runs a benchmark warmup times, from which the number of runs per repetition is chosen such that
+// each takes about target seconds, then times each repetition
+Stats Measure(
+    const Benchmark &benchmark, PerfCounters &counters, int warmup, int repetitions, double target
+) {
+    using Clock = std::chrono::steady_clock;
+    double single = 0;
+    for (int i = 0; i < std::max(warmup, 1); i++) {
+        const auto start = Clock::now();
+        checksum += benchmark.run();
+
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        single                                      = elapsed.count();
+    }
+    const size_t runs = std::max<size_t>(1, target / std::max(single, 1e-9));
+
+    std::vector<double> samples;
+    size_t total = 0;
+    counters.Start();
+    for (int i = 0; i < repetitions; i++) {
+        size_t operations = 0;
+        const auto start  = Clock::now();
+        for (size_t run = 0; run < runs; run++)
+            operations += benchmark.run();
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        samples.push_back(elapsed.count() / std::max<size_t>(operations, 1));
+        checksum += operations;
+        total += operations;
+    }
+    const PerfCounts counts = counters.Stop();
+
+    std::sort(samples.begin(), samples.end());
+    const size_t n      = samples.size();
+    const double median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    double mean = 0, variance = 0;
+    for (const auto sample : samples)
+        mean += sample / n;
+    for (const auto sample : samples)
+        variance += (sample - mean) * (sample - mean) / n;
+    return {median, std::sqrt(variance), total, counts};
+}
+
+// Writes the median and standard deviation of each benchmark, one per line
+bool SaveBaseline(const char *path, const std::vector<std::pair<std::string, Stats>> &results) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "{\n  \"benchmarks\": {\n");
+    for (size_t i = 0; i < results.size(); i++)
+        fprintf(
+            file, "    \"%s\": {\"median_ns\": %.4f, \"stddev_ns\": %.4f}%s\n",
+            results[i].first.c_str(), results[i].second.median, results[i].second.stddev,
+            i + 1 < results.size() ? "," : ""
+        );
+    fprintf(file, "  }\n}\n");
+    return fclose(file) == 0;
+}
+
+// Reads the medians of a baseline written by SaveBaseline, by benchmark name
+std::map<std::string, double> LoadBaseline(const char *path) {
+    std::map<std::string, double> medians;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        char name[64];
+        double median;
+        if (sscanf(line.c_str(), " \"%63[^\"]\": {\"median_ns\": %lf", name, &median) == 2)
+            medians[name] = median;
+    }
+    return medians;
+}
+
+// Usage: Bench [--warmup N] [--repetitions N] [--time MS] [--save PATH] [--compare PATH]
+//              [--threshold PCT] [--filter NAME]
+//  --warmup:      runs before timing, which also choose the runs per repetition (default 3)
+//  --repetitions: timed repetitions of each benchmark (default 15)
+//  --time:        target duration of each repetition in milliseconds (default 50)
+//  --save:        writes the results as a baseline JSON
+//  --compare:     compares the results against a baseline JSON
+//  --threshold:   percentage by which a median may exceed the baseline before it is reported as a
+//                 regression (default 5)
+//  --filter:      only runs benchmarks whose names contain NAME
+// Reports the median and standard deviation of the nanoseconds per operation of each benchmark,
+// over a fixed set of positions, followed by hardware events per operation if built with
+// JANKCHESS_PERF_COUNTERS. The exit code is nonzero if any benchmark regressed.
+int main(int argc, char **argv) {
+    int warmup          = 3;
+    int repetitions     = 15;
+    double target       = 0.05;
+    double threshold    = 5;
+    const char *save    = nullptr;
+    const char *compare = nullptr;
+    std::string_view filter;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            warmup = std::stoi(argv[++i]);
+        else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc)
+            repetitions = std::max(1, std::stoi(argv[++i]));
+        else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+            target = std::stod(argv[++i]) / 1000;
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+            save = argv[++i];
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+            compare = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            threshold = std::stod(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+    }
+
+    std::vector<Board> boards;
+    std::vector<MoveList> legal;
+    for (const auto FEN : POSITIONS) {
+        boards.emplace_back(FEN);
+        legal.push_back(GenerateMovesLegal(boards.back(), boards.back().Turn()));
+    }
+    char buffer[FEN_MAX_LENGTH];
+    Board parsed;
+
+    const Benchmark benchmarks[] = {
+        {"movegen_all",
+         [&] {
+             for (const auto &board : boards) {
+                 MoveList moves;
+                 GenerateMovesAll(moves, board, board.Turn());
+                 checksum += moves.size();
+             }
+             return POSITION_COUNT;
+         }},
+        {"movegen_legal",
+         [&] {
+             for (const auto &board : boards) {
+                 MoveList moves;
+                 GenerateMovesLegal(moves, board, board.Turn());
+                 checksum += moves.size();
+             }
+             return POSITION_COUNT;
+         }},
+        {"apply_undo",
+         [&] {
+             size_t operations = 0;
+             for (size_t i = 0; i < POSITION_COUNT; i++) {
+                 for (const auto move : legal[i]) {
+                     boards[i].ApplyMove(move);
+                     checksum += boards[i].GetHash();
+                     boards[i].UndoMove(move);
+                 }
+                 operations += legal[i].size();
+             }
+             return operations;
+         }},
+        {"is_king_safe",
+         [&] {
+             for (const auto &board : boards)
+                 checksum += board.IsKingSafe(WHITE) + board.IsKingSafe(BLACK);
+             return 2 * POSITION_COUNT;
+         }},
+        {"generate_attacks",
+         [&] {
+             for (const auto &board : boards)
+                 checksum += board.GenerateAttacks(WHITE) ^ board.GenerateAttacks(BLACK);
+             return 2 * POSITION_COUNT;
+         }},
+        {"fen_parse",
+         [&] {
+             for (const auto FEN : POSITIONS) {
+                 parsed.ParseFEN(FEN);
+                 checksum += parsed.GetHash();
+             }
+             return POSITION_COUNT;
+         }},
+        {"fen_export",
+         [&] {
+             for (const auto &board : boards)
+                 checksum += board.ExportFEN(buffer);
+             return POSITION_COUNT;
+         }},
+    };
+
+    const std::map<std::string, double> baseline =
+        compare ? LoadBaseline(compare) : std::map<std::string, double>();
+    if (compare && baseline.empty()) {
+        fprintf(stderr, "failed to read baseline %s\n", compare);
+        return 2;
+    }
+
+    printf("%-18s %12s %10s %14s", "benchmark", "median ns/op", "stddev", "ops/s");
+    printf(compare ? " %12s %8s\n" : "\n", "baseline", "change");
+    std::vector<std::pair<std::string, Stats>> results;
+    size_t regressions = 0;
+    PerfCounters counters;
+    for (const auto &benchmark : benchmarks) {
+        if (std::string_view(benchmark.name).find(filter) == std::string_view::npos) continue;
+        const Stats stats = Measure(benchmark, counters, warmup, repetitions, target);
+        results.emplace_back(benchmark.name, stats);
+        printf(
+            "%-18s %12.2f %10.2f %14.0f", benchmark.name, stats.median, stats.stddev,
+            1e9 / stats.median
+        );
+        if (!compare) {
+            printf("\n");
+            continue;
+        }
+        const auto base = baseline.find(benchmark.name);
+        if (base == baseline.end()) {
+            printf(" %12s\n", "none");
+            continue;
+        }
+        const double change  = 100 * (stats.median / base->second - 1);
+        const bool regressed = change > threshold;
+        regressions += regressed;
+        printf(" %12.2f %+7.1f%%%s\n", base->second, change, regressed ? " REGRESSION" : "");
+    }
+    if (counters.Available()) {
+        printf("\n");
+        for (const auto &[name, stats] : results) {
+            printf("%-18s", name.c_str());
+            PrintPerfCounts(stdout, stats.counts, stats.operations, "op");
+        }
+    }
+    printf("checksum %016zx\n", checksum);
+
+    if (save && !SaveBaseline(save, results)) {
+        fprintf(stderr, "failed to write baseline %s\n", save);
+        return 2;
+    }
+    if (regressions > 0) {
+        fprintf(stderr, "%zu benchmarks regressed by more than %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
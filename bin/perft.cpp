@@ -1,59 +1,166 @@
 #include <JankChess/board.hpp>
+#include <JankChess/instrument.hpp>
+#include <JankChess/masks.hpp>
 #include <JankChess/move_gen.hpp>
+#include <JankChess/perf_counters.hpp>
+#include <JankChess/perft.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace Chess;
 
-size_t Perft(Board &board, int depth) {
-    if (depth == 0) return 1;
-    MoveList moves;
-    GenerateMovesAll(moves, board, board.Turn());
+// Set if perft results are cached
+PerftCache *cache = nullptr;
+// Cache statistics, kept per thread to avoid contention, then summed once the thread is done
+thread_local size_t cache_probes = 0;
+thread_local size_t cache_hits   = 0;
+std::atomic<size_t> total_cache_probes;
+std::atomic<size_t> total_cache_hits;
 
-    size_t nodes = 0;
+void FlushCacheStats() {
+    total_cache_probes += std::exchange(cache_probes, 0);
+    total_cache_hits += std::exchange(cache_hits, 0);
+}
 
-    for (const auto &move : moves) {
-        board.ApplyMove(move);
-        if (board.IsKingSafe(!board.Turn())) nodes += Perft(board, depth - 1);
-        board.UndoMove(move);
-    }
+// The shared cache, if any, as consulted by perft
+// Each thread consults it through its own hooks, which add its statistics to the totals once done
+struct CacheHooks {
+    ~CacheHooks() { FlushCacheStats(); }
 
-    return nodes;
-}
+    std::optional<size_t> Probe(Hash hash, int depth) {
+        if (!cache || depth < PERFT_CACHE_MIN_DEPTH) return std::nullopt;
+        cache_probes++;
+        const std::optional<size_t> nodes = cache->Probe(hash, depth);
+        if (nodes) cache_hits++;
+        return nodes;
+    }
+    void Store(Hash hash, int depth, size_t nodes) {
+        if (cache) cache->Store(hash, depth, nodes);
+    }
+};
 
-void PerftDivide(Board &board, int depth) {
+void PerftDivide(Board &board, int depth, bool bulk, bool copy, size_t thread_count, int split) {
     if (depth == 0) {
         printf("0\n");
         return;
     }
     size_t total = 0;
 
-    const MoveList moves = GenerateMovesAll(board, board.Turn());
+    const MoveList moves = GenerateMovesLegal(board, board.Turn());
 
-    for (const auto move : moves) {
-        board.ApplyMove(move);
+    // Opened before any worker is created, such that the workers are counted too
+    PerfCounters counters;
+    counters.Start();
+    const auto t1 = std::chrono::steady_clock::now();
 
-        if (board.IsKingSafe(!board.Turn())) {
-            const size_t nodes = Perft(board, depth - 1);
-            printf("%s %zu\n", move.Export().c_str(), nodes);
-            total += nodes;
+    std::vector<size_t> nodes;
+    if (thread_count > 1)
+        nodes = PerftParallel(board, moves, depth, bulk, copy, thread_count, split, CacheHooks());
+    else {
+        CacheHooks hooks;
+        for (const auto move : moves) {
+            board.ApplyMove(move);
+            nodes.push_back(PerftAny(board, depth - 1, bulk, copy, hooks));
+            board.UndoMove(move);
         }
+    }
+
+    const PerfCounts counts = counters.Stop();
 
-        board.UndoMove(move);
+    const auto t2     = std::chrono::steady_clock::now();
+    const size_t time = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+    // Printed in generation order regardless of which thread finished first
+    for (size_t i = 0; i < moves.size(); i++) {
+        printf("%s %zu\n", moves[i].Export().c_str(), nodes[i]);
+        total += nodes[i];
     }
 
     printf("\n%zu\n", total);
+
+    fprintf(
+        stderr, "time %zu ms nps %zu\n", time, (total * 1000) / std::max<size_t>(time, 1)
+    );
+    if (counters.Available()) {
+        fprintf(stderr, "perf");
+        PrintPerfCounts(stderr, counts, total, "node");
+    }
+
+    if (cache) {
+        const size_t probes = total_cache_probes;
+        const size_t hits   = total_cache_hits;
+        fprintf(
+            stderr, "cache hits %zu probes %zu hit rate %.1f%%\n", hits, probes,
+            100.0 * hits / std::max<size_t>(probes, 1)
+        );
+    }
 }
 
+// Usage: Perft [--bulk] [--copy] [--threads N] [--split D] [--hash MB] [--trace PATH] <depth> <FEN>
+//              [moves]
+//  --bulk:       count the moves of the last ply instead of applying them
+//  --copy:       copy-make compact positions instead of make/unmake on a board
+//  --threads N:  number of worker threads, 0 for one per core (default 1)
+//  --split D:    plies below the root at which work is split into tasks (default 2)
+//  --hash MB:    size of the cache of subtree node counts, shared by all threads (default 0, off)
+//  --trace PATH: file to write timing zones to as Chrome trace JSON, if built with JANKCHESS_TRACE
+// Counts of hot path events are written to stderr if built with JANKCHESS_STATS
+// The slider backend in use is written to stderr. Built with JANKCHESS_NATIVE, the backend is fixed
+// at compile time and the binary only runs on CPUs like the one it was built on, so shipped builds
+// must leave it off.
 int main(int argc, char **argv) {
-    const size_t depth    = std::stoi(argv[1]);
-    const std::string FEN = std::string(argv[2]);
+    bool bulk           = false;
+    bool copy           = false;
+    size_t thread_count = 1;
+    int split           = 2;
+    size_t hash_mb      = 0;
+    const char *trace   = nullptr;
+    std::vector<char *> args;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bulk") == 0)
+            bulk = true;
+        else if (strcmp(argv[i], "--copy") == 0)
+            copy = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            thread_count = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--split") == 0 && i + 1 < argc)
+            split = std::stoi(argv[++i]);
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc)
+            hash_mb = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace = argv[++i];
+        else
+            args.push_back(argv[i]);
+    }
+    if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t depth    = std::stoi(args[0]);
+    const std::string FEN = std::string(args[1]);
     Board board;
-    if (argc == 3)
+    if (args.size() == 2)
         board = Board(FEN);
     else
-        board = Board(FEN, argv[3]);
+        board = Board(FEN, args[2]);
+
+    std::optional<PerftCache> perft_cache;
+    if (hash_mb > 0) cache = &perft_cache.emplace(hash_mb << 20);
 
-    PerftDivide(board, depth);
+    fprintf(stderr, "sliders %s\n", SliderBackendName(SLIDER_BACKEND));
+    PerftDivide(board, depth, bulk, copy, thread_count, split);
+
+    if (STATS_ENABLED) PrintCounters(stderr, CounterTotals());
+    if (trace && !WriteTrace(trace)) {
+        fprintf(stderr, "failed to write trace %s\n", trace);
+        return 1;
+    }
 
     return 0;
 }
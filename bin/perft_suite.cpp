@@ -0,0 +1,265 @@
+#include <JankChess/board.hpp>
+#include <JankChess/perf_counters.hpp>
+#include <JankChess/perft.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace Chess;
+
+// A line of the suite, numbered from one
+struct Job {
+    size_t line_number;
+    std::string line;
+};
+
+// Lines read but not yet taken by a worker
+// Bounded, such that a suite of any size is streamed rather than read up front
+class JobQueue {
+public:
+    explicit JobQueue(size_t capacity) : capacity(capacity) {}
+
+    void Push(Job job) {
+        std::unique_lock lock(mutex);
+        not_full.wait(lock, [&] { return jobs.size() < capacity; });
+        jobs.push_back(std::move(job));
+        not_empty.notify_one();
+    }
+    // Wakes every worker waiting on an empty queue, after which Pop returns nullopt once empty
+    void Close() {
+        std::lock_guard lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+    }
+    std::optional<Job> Pop() {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [&] { return !jobs.empty() || closed; });
+        if (jobs.empty()) return std::nullopt;
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        not_full.notify_one();
+        return job;
+    }
+
+private:
+    size_t capacity;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+    std::deque<Job> jobs;
+};
+
+// A node count to verify, as given by an operation such as ";D3 8902"
+struct Expectation {
+    int depth;
+    size_t nodes;
+};
+
+// Parses the operations of a line from offset, being where its FEN ends, skipping those other than
+// depths
+// Returns the offset within the line of the first malformed operation, if any
+std::optional<size_t>
+ParseExpectations(std::string_view line, size_t offset, std::vector<Expectation> &expectations) {
+    while (offset < line.size()) {
+        const size_t end    = std::min(line.find(';', offset), line.size());
+        const size_t first  = std::min(line.find_first_not_of(" \t\r", offset), end);
+        std::string_view op = line.substr(first, end - first);
+        offset              = end + 1;
+        if (op.size() < 2 || op[0] != 'D' || !isdigit(op[1])) continue;
+
+        Expectation expectation;
+        const char *last = op.data() + op.size();
+        auto result      = std::from_chars(op.data() + 1, last, expectation.depth);
+        if (result.ec != std::errc() || result.ptr == last || *result.ptr != ' ') return first;
+        result = std::from_chars(result.ptr + 1, last, expectation.nodes);
+        if (result.ec != std::errc()) return first;
+        expectations.push_back(expectation);
+    }
+    return std::nullopt;
+}
+
+// Writes results as they complete, in either JSON or CSV
+// Rows are in order of completion rather than of the suite, so each records its line
+class Report {
+public:
+    Report(FILE *file, bool json) : file(file), json(json) {
+        fprintf(file, json ? "[\n" : "line,fen,depth,expected,nodes,time_us,nps,passed\n");
+    }
+    ~Report() {
+        if (json) fprintf(file, "\n]\n");
+        fflush(file);
+    }
+
+    void Row(
+        size_t line, std::string_view FEN, int depth, size_t expected, size_t nodes, double seconds
+    ) {
+        const size_t nps     = seconds > 0 ? static_cast<size_t>(nodes / seconds) : 0;
+        const size_t time_us = static_cast<size_t>(seconds * 1e6);
+        const char *pass     = nodes == expected ? "true" : "false";
+        const int length     = static_cast<int>(FEN.size());
+        std::lock_guard lock(mutex);
+        if (json)
+            fprintf(
+                file,
+                "%s  {\"line\": %zu, \"fen\": \"%.*s\", \"depth\": %d, \"expected\": %zu, "
+                "\"nodes\": %zu, \"time_us\": %zu, \"nps\": %zu, \"passed\": %s}",
+                rows++ == 0 ? "" : ",\n", line, length, FEN.data(), depth, expected, nodes,
+                time_us, nps, pass
+            );
+        else
+            fprintf(
+                file, "%zu,%.*s,%d,%zu,%zu,%zu,%zu,%s\n", line, length, FEN.data(), depth,
+                expected, nodes, time_us, nps, pass
+            );
+    }
+
+private:
+    FILE *file;
+    bool json;
+    size_t rows = 0;
+    std::mutex mutex;
+};
+
+// Usage: PerftSuite [--threads N] [--max-depth D] [--full] [--csv] [--output PATH] <EPD>
+//  --threads N:   number of worker threads, 0 for one per core (default 0)
+//  --max-depth D: skips expectations deeper than D (default none)
+//  --full:        applies the last ply instead of counting its moves
+//  --csv:         reports CSV instead of JSON
+//  --output PATH: file to write the report to (default stdout)
+// Each line of the EPD is a FEN followed by operations such as ";D1 20 ;D2 400", where every
+// depth is verified. Positions are distributed across the threads, one line at a time.
+// A summary is written to stderr, and the exit code is nonzero if any count differs, or any line
+// cannot be parsed.
+int main(int argc, char **argv) {
+    size_t thread_count = 0;
+    int max_depth       = INT32_MAX;
+    bool full           = false;
+    bool json           = true;
+    const char *output  = nullptr;
+    const char *path    = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            thread_count = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--max-depth") == 0 && i + 1 < argc)
+            max_depth = std::stoi(argv[++i]);
+        else if (strcmp(argv[i], "--full") == 0)
+            full = true;
+        else if (strcmp(argv[i], "--csv") == 0)
+            json = false;
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else
+            path = argv[i];
+    }
+    if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+    if (!path) {
+        fprintf(stderr, "usage: PerftSuite [options] <EPD>\n");
+        return 2;
+    }
+
+    std::ifstream suite(path);
+    if (!suite) {
+        fprintf(stderr, "failed to open %s\n", path);
+        return 2;
+    }
+    FILE *file = output ? fopen(output, "w") : stdout;
+    if (!file) {
+        fprintf(stderr, "failed to open %s\n", output);
+        return 2;
+    }
+
+    // Opened before any worker is created, such that the workers are counted too
+    PerfCounters counters;
+    counters.Start();
+    std::atomic<size_t> positions = 0, failures = 0, total_nodes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        Report report(file, json);
+        JobQueue queue(4 * thread_count);
+        std::vector<std::thread> threads;
+        for (size_t id = 0; id < thread_count; id++) {
+            threads.emplace_back([&] {
+                Board board;
+                std::vector<Expectation> expectations;
+                while (std::optional<Job> job = queue.Pop()) {
+                    const std::string_view line = job->line;
+                    const FENResult result      = board.ParseFEN(line);
+                    expectations.clear();
+                    const std::optional<size_t> malformed =
+                        result.error == FENError::None
+                            ? ParseExpectations(line, result.offset, expectations)
+                            : std::nullopt;
+                    if (result.error != FENError::None || malformed) {
+                        fprintf(
+                            stderr, "line %zu: invalid %s at offset %zu\n", job->line_number,
+                            malformed ? "operation" : FENErrorName(result.error),
+                            malformed ? *malformed : result.offset
+                        );
+                        failures++;
+                        continue;
+                    }
+                    positions++;
+
+                    const std::string_view FEN = line.substr(0, result.offset);
+                    for (const auto expectation : expectations) {
+                        if (expectation.depth > max_depth) continue;
+                        const auto t1 = std::chrono::steady_clock::now();
+                        const int depth    = expectation.depth;
+                        const size_t nodes = full ? Perft(board, depth) : PerftBulk(board, depth);
+                        const std::chrono::duration<double> elapsed =
+                            std::chrono::steady_clock::now() - t1;
+
+                        report.Row(
+                            job->line_number, FEN, expectation.depth, expectation.nodes, nodes,
+                            elapsed.count()
+                        );
+                        total_nodes += nodes;
+                        if (nodes != expectation.nodes) {
+                            fprintf(
+                                stderr, "line %zu: depth %d expected %zu nodes, counted %zu\n",
+                                job->line_number, expectation.depth, expectation.nodes, nodes
+                            );
+                            failures++;
+                        }
+                    }
+                }
+            });
+        }
+
+        std::string line;
+        for (size_t line_number = 1; std::getline(suite, line); line_number++) {
+            // Blank lines and comments are skipped
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[0] == '#') continue;
+            queue.Push({line_number, std::move(line)});
+        }
+        queue.Close();
+        for (auto &thread : threads)
+            thread.join();
+    }
+    const PerfCounts counts = counters.Stop();
+    if (output) fclose(file);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    fprintf(
+        stderr, "positions %zu failures %zu nodes %zu time %.0f ms nps %.0f threads %zu\n",
+        positions.load(), failures.load(), total_nodes.load(), elapsed.count() * 1000,
+        total_nodes / std::max(elapsed.count(), 1e-9), thread_count
+    );
+    if (counters.Available()) {
+        fprintf(stderr, "perf");
+        PrintPerfCounts(stderr, counts, total_nodes, "node");
+    }
+    return failures > 0;
+}
@@ -0,0 +1,99 @@
+#include <JankChess/board.hpp>
+#include <JankChess/instrument.hpp>
+#include <JankChess/search.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Chess;
+
+static const std::string POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+    "2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - - 0 22",
+};
+
+// Usage: SearchBench [--threads N[,N...]] [--depth D] [--hash MB] [--eval-file PATH]
+//  --threads: thread counts to compare, each against the first (default 1,2,4,... up to one per
+//             core)
+//  --depth:   depth to which each position is searched (default 9)
+//  --hash:    size of the transposition table, which is cleared before each search (default 64)
+//  --eval-file: network by which to evaluate, rather than material and placement
+// Reports, per thread count, the time to search all positions to depth, the nodes searched by
+// each thread, and the speedup in time and nodes per second over the first thread count
+// Counts of hot path events follow if built with JANKCHESS_STATS
+int main(int argc, char **argv) {
+    std::vector<size_t> thread_counts;
+    int depth      = 9;
+    size_t hash_mb = 64;
+    std::shared_ptr<const Network> network;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            for (char *count = strtok(argv[++i], ","); count; count = strtok(nullptr, ","))
+                thread_counts.push_back(std::max(1ul, std::stoul(count)));
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc)
+            depth = std::stoi(argv[++i]);
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc)
+            hash_mb = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--eval-file") == 0 && i + 1 < argc) {
+            network = Network::Load(argv[++i]);
+            if (!network) {
+                fprintf(stderr, "failed to load network %s\n", argv[i]);
+                return 1;
+            }
+            printf("network %s kernels %s\n", argv[i], NNUEKernelName());
+        }
+    }
+    if (thread_counts.empty()) {
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t count = 1; count < cores; count *= 2)
+            thread_counts.push_back(count);
+        thread_counts.push_back(cores);
+    }
+
+    size_t base_time = 0;
+    size_t base_nps  = 0;
+    for (const auto thread_count : thread_counts) {
+        Searcher searcher(hash_mb, thread_count);
+        searcher.SetNetwork(network);
+        size_t time  = 0;
+        size_t nodes = 0;
+        std::vector<size_t> thread_nodes(thread_count);
+        for (const auto &FEN : POSITIONS) {
+            searcher.Clear();
+            const SearchResult result = searcher.Search(Board(FEN), {.depth = depth});
+            time += result.time;
+            nodes += result.nodes;
+            for (size_t i = 0; i < thread_count; i++)
+                thread_nodes[i] += result.thread_nodes[i];
+        }
+
+        const size_t nps = nodes * 1000 / std::max<size_t>(time, 1);
+        if (base_time == 0) {
+            base_time = std::max<size_t>(time, 1);
+            base_nps  = std::max<size_t>(nps, 1);
+        }
+        printf(
+            "threads %zu time %zu ms nodes %zu nps %zu speedup %.2f nps speedup %.2f\n",
+            thread_count, time, nodes, nps, (double)base_time / std::max<size_t>(time, 1),
+            (double)nps / base_nps
+        );
+        printf("  thread nodes");
+        for (const auto count : thread_nodes)
+            printf(" %zu", count);
+        printf("\n");
+    }
+    // Summed over every search, each of whose threads have exited with its searcher
+    if (STATS_ENABLED) PrintCounters(stdout, CounterTotals());
+
+    return 0;
+}
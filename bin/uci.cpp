@@ -0,0 +1,291 @@
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/search.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Chess;
+
+static const std::string STARTPOS = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Lines are written by both the input and search threads, so each is written whole under a lock
+std::mutex output_mutex;
+
+void Send(const std::string &line) {
+    std::lock_guard lock(output_mutex);
+    fputs((line + "\n").c_str(), stdout);
+    fflush(stdout);
+}
+
+std::string FormatScore(int score) {
+    if (!IsMateScore(score)) return "cp " + std::to_string(score);
+    // In moves rather than plies, negative if the engine is being mated
+    const int plies = SCORE_MATE - std::abs(score);
+    return "mate " + std::to_string(score > 0 ? (plies + 1) / 2 : -plies / 2);
+}
+
+// Parses the value of a spin option, clamped to the range advertised for it
+// Returns nullopt if the value is not a number
+std::optional<size_t> ParseSpin(const std::string &value, size_t min, size_t max) {
+    size_t parsed;
+    const char *last  = value.data() + value.size();
+    const auto result = std::from_chars(value.data(), last, parsed);
+    if (result.ptr != last || value.empty()) return std::nullopt;
+    if (result.ec == std::errc::result_out_of_range) return max;
+    if (result.ec != std::errc()) return std::nullopt;
+    return std::clamp(parsed, min, max);
+}
+
+// Returns text without leading and trailing whitespace
+std::string Trim(const std::string &text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+// Owns the search thread, such that the input thread only ever starts or stops it
+// The search never reads input, and the input thread never waits upon the search except to stop
+// it, so stop and isready are answered immediately
+class Engine {
+public:
+    ~Engine() { Stop(); }
+
+    // setoption name <name> [value <value>], where both the name and value may contain spaces
+    void SetOption(std::istringstream &args) {
+        std::string token, name, value;
+        args >> token;
+        while (args >> token && token != "value")
+            name += (name.empty() ? "" : " ") + token;
+        std::getline(args, value);
+        value = Trim(value);
+        Stop();
+        if (name == "Clear Hash")
+            searcher.Clear();
+        else if (name == "Hash" || name == "Threads") {
+            const std::optional<size_t> parsed =
+                name == "Hash" ? ParseSpin(value, 1, 65536) : ParseSpin(value, 1, 1024);
+            if (!parsed) {
+                Send("info string invalid value " + value + " for " + name);
+                return;
+            }
+            // The prior table or threads are kept if the new ones cannot be allocated
+            try {
+                if (name == "Hash")
+                    searcher.SetHash(*parsed);
+                else
+                    searcher.SetThreads(*parsed);
+            } catch (const std::bad_alloc &) {
+                Send("info string failed to allocate " + name + " " + std::to_string(*parsed));
+            }
+        } else if (name == "EvalFile") {
+            // An empty path returns to the evaluation by material and placement
+            if (value == "<empty>") value.clear();
+            std::shared_ptr<const Network> network = Network::Load(value);
+            if (!network && !value.empty()) Send("info string failed to load network " + value);
+            searcher.SetNetwork(network);
+        }
+    }
+
+    void NewGame() {
+        Stop();
+        searcher.Clear();
+    }
+
+    // position [startpos | fen <FEN>] [moves <moves>]
+    void Position(std::istringstream &args) {
+        std::string token, FEN, moves;
+        args >> token;
+        if (token == "startpos") {
+            FEN = STARTPOS;
+            args >> token;
+        } else if (token == "fen")
+            while (args >> token && token != "moves")
+                FEN += token + " ";
+        if (token == "moves")
+            while (args >> token)
+                moves += (moves.empty() ? "" : " ") + token;
+
+        Stop();
+        Board parsed;
+        if (const FENResult result = parsed.ParseFEN(FEN); result.error != FENError::None) {
+            Send(
+                "info string invalid " + std::string(FENErrorName(result.error)) +
+                " in fen at offset " + std::to_string(result.offset)
+            );
+            return;
+        }
+        // Each move is matched against those legal in the position, as it is applied unchecked
+        // Positions before the current one are kept apart from the board, which keeps only the most
+        // recent, such that repetitions of any earlier position are found
+        GameHistory played;
+        std::istringstream move_stream(moves);
+        while (move_stream >> token) {
+            const MoveList legal = GenerateMovesLegal(parsed, parsed.Turn());
+            const auto move      = std::find_if(legal.begin(), legal.end(), [&](Move move) {
+                return move.Export() == token;
+            });
+            if (move == legal.end()) {
+                Send("info string illegal move " + token);
+                return;
+            }
+            played.push_back(parsed.GetHash());
+            parsed.ApplyMove(*move);
+        }
+        history = std::move(played);
+        board   = parsed;
+        board.AttachHistory(&history);
+    }
+
+    // go [depth N] [nodes N] [movetime MS] [wtime MS] [btime MS] [winc MS] [binc MS]
+    //    [movestogo N] [infinite]
+    void Go(std::istringstream &args) {
+        SearchLimits limits;
+        size_t time[COLOR_COUNT] = {0, 0};
+        size_t inc[COLOR_COUNT]  = {0, 0};
+        size_t moves_to_go       = 30;
+        bool infinite            = false;
+        std::string token;
+        while (args >> token) {
+            if (token == "depth")
+                args >> limits.depth;
+            else if (token == "nodes")
+                args >> limits.nodes;
+            else if (token == "movetime")
+                args >> limits.time;
+            else if (token == "wtime")
+                args >> time[WHITE];
+            else if (token == "btime")
+                args >> time[BLACK];
+            else if (token == "winc")
+                args >> inc[WHITE];
+            else if (token == "binc")
+                args >> inc[BLACK];
+            else if (token == "movestogo")
+                args >> moves_to_go;
+            else if (token == "infinite")
+                infinite = true;
+        }
+
+        // An even share of the remaining time, keeping a margin for communication
+        const Color us = board.Turn();
+        if (time[us] && !limits.time) {
+            const size_t margin = std::min<size_t>(50, time[us] / 2);
+            limits.time         = time[us] / std::max<size_t>(moves_to_go, 1) + inc[us] / 2;
+            limits.time         = std::clamp<size_t>(limits.time, 1, time[us] - margin);
+        }
+
+        Stop();
+        stopped = false;
+        search  = std::thread([this, limits, infinite] { Run(limits, infinite); });
+    }
+
+    // Stops the search, if any, after which its best move has been sent
+    void Stop() {
+        {
+            std::lock_guard lock(mutex);
+            stopped = true;
+        }
+        searcher.Stop();
+        finished.notify_all();
+        if (search.joinable()) search.join();
+    }
+
+private:
+    Board board;
+    // Shared by the boards of every search thread, so only replaced while no search is running
+    GameHistory history;
+    Searcher searcher;
+    std::thread search;
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool stopped = false;
+
+    void Run(SearchLimits limits, bool infinite) {
+        const auto start = std::chrono::steady_clock::now();
+        bool done        = false;
+
+        // Reports progress once a second, as iterations may take far longer
+        std::thread reporter([&] {
+            std::unique_lock lock(mutex);
+            while (!finished.wait_for(lock, std::chrono::seconds(1), [&] { return done; })) {
+                const size_t nodes = searcher.Nodes();
+                const size_t time  = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        std::chrono::steady_clock::now() - start
+                )
+                                        .count();
+                Send(
+                    "info nodes " + std::to_string(nodes) + " nps " +
+                    std::to_string(nodes * 1000 / std::max<size_t>(time, 1)) + " time " +
+                    std::to_string(time)
+                );
+            }
+        });
+
+        const SearchResult result = searcher.Search(board, limits, [](const SearchResult &result) {
+            std::string line = "info depth " + std::to_string(result.depth) + " score " +
+                               FormatScore(result.score) + " nodes " +
+                               std::to_string(result.nodes) + " nps " + std::to_string(result.nps) +
+                               " time " + std::to_string(result.time) + " pv";
+            for (const auto move : result.pv)
+                line += " " + move.Export();
+            Send(line);
+        });
+
+        {
+            std::unique_lock lock(mutex);
+            // An infinite search must not report its move until told to stop, even if it ends
+            if (infinite) finished.wait(lock, [&] { return stopped; });
+            done = true;
+        }
+        finished.notify_all();
+        reporter.join();
+
+        Send("bestmove " + (result.best_move == Move() ? "0000" : result.best_move.Export()));
+    }
+};
+
+// Speaks the universal chess interface over standard input and output
+int main() {
+    Engine engine;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream args(line);
+        std::string command;
+        args >> command;
+
+        if (command == "uci") {
+            Send("id name JankChess");
+            Send("id author Jan M. D. Hansen");
+            Send("option name Hash type spin default 16 min 1 max 65536");
+            Send("option name Threads type spin default 1 min 1 max 1024");
+            Send("option name EvalFile type string default <empty>");
+            Send("option name Clear Hash type button");
+            Send("uciok");
+        } else if (command == "isready")
+            Send("readyok");
+        else if (command == "setoption")
+            engine.SetOption(args);
+        else if (command == "ucinewgame")
+            engine.NewGame();
+        else if (command == "position")
+            engine.Position(args);
+        else if (command == "go")
+            engine.Go(args);
+        else if (command == "stop")
+            engine.Stop();
+        else if (command == "quit")
+            break;
+    }
+
+    return 0;
+}
@@ -27,6 +27,17 @@ constexpr Square msb(BB x) {
 // Returns the number of 1-bits in x
 constexpr int popcount(BB x) { return __builtin_popcountll(x); }
 
+#if defined(__x86_64__)
+// Gathers the bits of x selected by mask into the low bits of the result
+// Emitted directly as BMI2 PEXT, so it builds without -mbmi2, but must only be executed on a CPU
+// which supports it
+inline BB pext(BB x, BB mask) {
+    BB result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(x), "rm"(mask));
+    return result;
+}
+#endif
+
 template <Direction D>
 constexpr BB shift(BB bb) {
     if constexpr (D == NORTH)
@@ -69,4 +80,9 @@ constexpr BB shift_up(BB x, Color color) {
     else
         return x >> 8;
 }
+
+template <Color C>
+constexpr BB shift_up(BB x) {
+    return shift<C == WHITE ? NORTH : SOUTH>(x);
+}
 } // namespace Chess
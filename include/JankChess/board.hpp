@@ -2,8 +2,33 @@
 
 #include <JankChess/board.hpp>
 #include <JankChess/move.hpp>
+#include <JankChess/nnue.hpp>
+#include <JankChess/psqt.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace Chess {
+// Longest FEN string written by Board::ExportFEN, including the terminating null
+constexpr size_t FEN_MAX_LENGTH = 128;
+
+// The field of a FEN string which could not be parsed
+enum class FENError { None, Pieces, Turn, Castling, EP, Clocks };
+
+struct FENResult {
+    FENError error;
+    // Offset of the offending character if an error occured, and otherwise the number of
+    // characters parsed
+    size_t offset;
+};
+
+// Returns the name of the field of an error, e.g. "castling"
+const char *FENErrorName(FENError error) noexcept;
+
+// Hashes of the positions of a game, oldest first, by which repetitions of positions before those a
+// board has kept are found
+typedef std::vector<Hash> GameHistory;
+
 class Board {
 public:
     // Used when restoring state after a move
@@ -14,16 +39,19 @@ public:
     };
     // CONSTRUCTOR
 
-    // Creates a board equvilant to the given FEN string
-    Board(std::string FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") noexcept;
+    // Creates a board equvilant to the given FEN string, which must be valid
+    Board(
+        std::string_view FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+    ) noexcept;
     // Creates a board from a FEN string, then applies a sequence of moves
     Board(const std::string &FEN, const std::string &moves) noexcept;
 
     // ACCESS
 
-    // Returns the number of moves applied in total
+    // Returns the number of moves applied in total, including those before the FEN it was created
+    // from
     size_t MoveCount() const noexcept;
-    // Returns the number of moves currently applied
+    // Returns the number of moves currently applied, which is not bounded by MAX_PLY
     size_t Ply() const noexcept;
     // Returns the color whose turn it is
     Color Turn() const noexcept;
@@ -34,6 +62,33 @@ public:
     Castling GetCastling(Color color) const noexcept;
     // Returns the current position's hash
     Hash GetHash() const noexcept;
+    // Returns the number of moves since the last capture or pawn move
+    int HalfmoveClock() const noexcept;
+    // Returns whether the current position has occurred before, since the last capture or pawn move
+    // Only the last MAX_PLY - 1 positions of the board, and those of the attached history, are known
+    bool IsRepetition() const noexcept;
+    // Returns whether fifty moves have been made by each side without a capture or pawn move
+    // A checkmate upon the last of them takes precedence, which is left to the caller
+    bool IsFiftyMoveDraw() const noexcept;
+    // Returns the FEN string of the current position
+    std::string ExportFEN() const;
+    // Writes the FEN string of the current position to buffer, which must hold FEN_MAX_LENGTH
+    // characters, followed by a null, and returns its length
+    size_t ExportFEN(char *buffer) const noexcept;
+    // Returns the hash of the current position computed without the incremental updates
+    // Debug builds check it against GetHash after every move
+    Hash ComputeHashFromScratch() const noexcept;
+    // Returns the material and piece-square score of the current position, from the perspective
+    // of white
+    Score GetPSQT() const noexcept;
+    // Returns the game phase of the current position, see PHASE_MAX
+    int GetPhase() const noexcept;
+    // Returns the score and phase of the current position computed without the incremental updates
+    // Debug builds check them against GetPSQT and GetPhase after every move
+    Score ComputePSQTFromScratch() const noexcept;
+    int ComputePhaseFromScratch() const noexcept;
+    // Returns the attached accumulators, or nullptr if none are attached
+    const AccumulatorStack *GetAccumulators() const noexcept;
     // Returns all pieces
     BB Pieces() const noexcept;
     // Returns pieces of type
@@ -48,37 +103,112 @@ public:
     Color SquareColor(Square square) const noexcept;
     // Returns whether the king of a color is under attack
     bool IsKingSafe(Color color) const noexcept;
+    template <Color Us>
+    bool IsKingSafe() const noexcept;
     // Returns an attack bitboard
     BB GenerateAttacks(Color color) const noexcept;
+    // Returns an attack bitboard, where sliders are blocked by occ rather than the board
+    BB GenerateAttacks(Color color, BB occ) const noexcept;
+    // Returns the pieces of either color attacking square
+    BB AttackersTo(Square square) const noexcept;
+    // Returns the pieces of either color attacking square, where sliders are blocked by occ rather
+    // than the board, such that removing a piece from occ reveals the sliders behind it
+    // Pieces absent from occ are not excluded, so callers removing attackers should mask by occ
+    BB AttackersTo(Square square, BB occ) const noexcept;
+    // Returns the squares attacked by color
+    // Maintained incrementally if built with JANKCHESS_ATTACK_MAPS, and otherwise generated
+    BB Attacks(Color color) const noexcept;
+    // Returns the number of pieces of color attacking square
+    // Maintained incrementally if built with JANKCHESS_ATTACK_MAPS, and otherwise counted
+    int AttackerCount(Color color, Square square) const noexcept;
 
     // MODIFIERS
 
     // Resets board to an empty state
     void ClearBoard();
+    // Resets board to the position of a FEN string, whose clocks are optional, without allocating
+    // Parsing stops after the clocks, or the en passant square if they are absent, such that the
+    // rest of e.g. an EPD line is left to the caller. On error, the board is left partially set.
+    FENResult ParseFEN(std::string_view FEN) noexcept;
     // Modifies board to a state where a piece of given color is on square
+    // Accumulate is false where the accumulators are known to be detached, or to be intact, as when
+    // undoing a move
+    template <bool Accumulate = true>
     void PlacePiece(Color color, Piece piece, Square square) noexcept;
     // Modifies board to a state where no piece of color is on square
+    template <bool Accumulate = true>
     void RemovePiece(Color color, Piece piece, Square square) noexcept;
     // Modifies board to a state where the move is applied
     void ApplyMove(Move move) noexcept;
+    // Same as ApplyMove, where Us must be the color whose turn it is
+    template <Color Us>
+    void ApplyMove(Move move) noexcept;
     // Modifies board to a state where the move is undone
     void UndoMove(Move move) noexcept;
+    // Same as UndoMove, where Us must be the color who made the move
+    template <Color Us>
+    void UndoMove(Move move) noexcept;
+    // Keeps the accumulators up to date with every subsequent change to the board, starting from
+    // the current position, until another, or nullptr, is attached
+    // The stack is not owned, and must not be shared with another board
+    void AttachAccumulators(AccumulatorStack *accumulators) noexcept;
+    // Makes the positions before the current one, as given by history, known to IsRepetition
+    // The history is not owned, and is shared by copies of the board, so must neither change nor be
+    // destroyed while any is in use. Moves made before it was attached must not be undone.
+    void AttachHistory(const GameHistory *history) noexcept;
 
 private:
+    // What a move changed which cannot be recomputed when it is undone, along with the hash by
+    // which repetitions are found
+    // Packed into 16 bytes, as boards are copied for every thread
     struct PlyInfo {
-        Square ep;
+        Hash hash;
+        uint16_t halfmove;
         std::array<Castling, COLOR_COUNT> castling;
-        Piece captured;
+        Square ep : 8;
+        Piece captured : 8;
     };
+    static_assert(sizeof(PlyInfo) == 16);
     BB pieces[PIECE_COUNT];
     BB colors[COLOR_COUNT];
     Piece square_pieces[SQUARE_COUNT];
     Color turn;
     Hash hash;
+    Score psqt;
+    int phase;
     size_t move_count;
     size_t ply;
-    PlyInfo history[MAX_PLY];
+    // The lowest ply whose undo information is still kept, below which no move may be undone
+    size_t oldest_ply;
+    // The most recent plies, indexed by ply modulo MAX_PLY, such that games of any length may be
+    // played while only the last MAX_PLY - 1 moves may be undone
+    PlyInfo stack[MAX_PLY];
+    // Positions before the ply history_ply, owned by the caller, or nullptr if none are known
+    const GameHistory *history;
+    size_t history_ply;
+    AccumulatorStack *accumulators;
+#ifdef JANKCHESS_ATTACK_MAPS
+    // Squares attacked by the piece on each square, or none if the square is empty
+    BB square_attacks[SQUARE_COUNT];
+    uint8_t attacker_counts[COLOR_COUNT][SQUARE_COUNT];
+    // Squares whose count is above zero
+    BB attacks[COLOR_COUNT];
+
+    // Adds, or removes, attacks by color upon the squares of bb
+    template <bool Add>
+    void CountAttacks(Color color, BB bb) noexcept;
+    // Updates the attacks of the piece, if any, on square, and those of every slider whose rays
+    // cross it, after the piece on square has been flipped
+    void UpdateAttacks(Color color, Piece piece, Square square) noexcept;
+#endif
+
+    PlyInfo &Stack(size_t ply) noexcept { return this->stack[ply % MAX_PLY]; }
+    const PlyInfo &Stack(size_t ply) const noexcept { return this->stack[ply % MAX_PLY]; }
 
+    template <bool Accumulate>
     void FlipPiece(Color color, Piece piece, Square square) noexcept;
+    // Same as ApplyMove<Us>, where Accumulate is whether accumulators are attached
+    template <Color Us, bool Accumulate>
+    void DoMove(Move move) noexcept;
 };
 } // namespace Chess
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/types.hpp>
+
+namespace Chess {
+// Returns the static evaluation of board in centipawns, from the perspective of the side to move
+// That is the network of the board's accumulators if attached, and otherwise its material and
+// piece-square score, both of which the board maintains such that this is constant time
+int Evaluate(const Board &board) noexcept;
+} // namespace Chess
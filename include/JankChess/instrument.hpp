@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef JANKCHESS_TRACE
+#include <chrono>
+#include <vector>
+#endif
+
+namespace Chess {
+// Events counted on hot paths if built with JANKCHESS_STATS
+enum Counter {
+    // Moves generated into a list by the GenerateMoves functions, by type
+    // Moves handed directly to a visitor, e.g. by copy-make perft, are not counted
+    COUNTER_MOVES_QUIET,
+    COUNTER_MOVES_CASTLE,
+    COUNTER_MOVES_CAPTURE,
+    COUNTER_MOVES_EP,
+    COUNTER_MOVES_PROMOTION,
+    // Attacks of the opponent computed to determine the legality of castling
+    COUNTER_CASTLING_ATTACKS,
+    // Pseudo-legal moves searched, then undone as they left the king in check
+    COUNTER_ILLEGAL_MOVES,
+    COUNTER_MOVES_APPLIED,
+    COUNTER_KING_SAFETY_CHECKS,
+    COUNTER_NONE
+};
+#define COUNTER_COUNT 9
+
+// The name of each counter, as printed
+constexpr std::array<const char *, COUNTER_COUNT> COUNTER_NAMES = {
+    "moves_quiet",      "moves_castle",  "moves_capture", "moves_ep",          "moves_promotion",
+    "castling_attacks", "illegal_moves", "moves_applied", "king_safety_checks",
+};
+
+typedef std::array<uint64_t, COUNTER_COUNT> Counters;
+
+#ifdef JANKCHESS_STATS
+constexpr bool STATS_ENABLED = true;
+
+// Counts of a single thread, added to the totals once the thread exits
+struct ThreadCounters {
+    Counters counts = {};
+    ~ThreadCounters();
+};
+inline thread_local ThreadCounters thread_counters;
+
+#define JANKCHESS_COUNT(counter) (Chess::thread_counters.counts[counter]++)
+#else
+constexpr bool STATS_ENABLED = false;
+
+#define JANKCHESS_COUNT(counter) ((void)0)
+#endif
+
+// Returns the counts of every thread which has exited, plus those of the calling thread
+// Always zero unless built with JANKCHESS_STATS
+Counters CounterTotals() noexcept;
+// Writes each nonzero count, one per line
+void PrintCounters(FILE *file, const Counters &counters);
+
+#ifdef JANKCHESS_TRACE
+constexpr bool TRACE_ENABLED = true;
+
+// Zones recorded by a thread before the rest are dropped, such that deep runs do not exhaust memory
+#define TRACE_MAX_EVENTS (1 << 20)
+
+// A zone which has been left, in nanoseconds since the first zone of the process was entered
+struct TraceEvent {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+};
+
+// Zones recorded by a single thread, added to those of the process once the thread exits
+struct ThreadTrace {
+    std::vector<TraceEvent> events;
+    size_t dropped = 0;
+    ~ThreadTrace();
+};
+inline thread_local ThreadTrace thread_trace;
+
+// Nanoseconds since the first call
+int64_t TraceNow() noexcept;
+
+// Records the time from its construction until its destruction as a zone of the calling thread
+class TraceZone {
+public:
+    explicit TraceZone(const char *name) noexcept : name(name), start(TraceNow()) {}
+    ~TraceZone() {
+        if (thread_trace.events.size() >= TRACE_MAX_EVENTS) {
+            thread_trace.dropped++;
+            return;
+        }
+        thread_trace.events.push_back({name, start, TraceNow() - start});
+    }
+    TraceZone(const TraceZone &)            = delete;
+    TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+    const char *name;
+    int64_t start;
+};
+
+#define JANKCHESS_ZONE_VARIABLE(line) trace_zone_##line
+#define JANKCHESS_ZONE_NAME(line) JANKCHESS_ZONE_VARIABLE(line)
+#define JANKCHESS_ZONE(name) const Chess::TraceZone JANKCHESS_ZONE_NAME(__LINE__)(name)
+#else
+constexpr bool TRACE_ENABLED = false;
+
+#define JANKCHESS_ZONE(name) ((void)0)
+#endif
+
+// Writes the zones of every thread which has exited, plus those of the calling thread, as Chrome
+// trace JSON, which may be opened in chrome://tracing or Perfetto
+// Returns false if the file could not be written, or if not built with JANKCHESS_TRACE
+bool WriteTrace(const char *path);
+} // namespace Chess
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "JankChess/bb.hpp"
 #include "JankChess/types.hpp"
 
 namespace Chess {
@@ -36,6 +37,68 @@ extern const std::array<std::array<BB, 8>, SQUARE_COUNT> RINGS;
 extern const std::array<std::array<BB, SQUARE_COUNT>, SQUARE_COUNT> SQ_RAYS;
 extern const std::array<std::array<BB, DIRECTION_COUNT>, SQUARE_COUNT> DIR_RAYS;
 extern const std::array<std::array<BB, SQUARE_COUNT>, SQUARE_COUNT> XRAYS;
+extern const std::array<std::array<BB, SQUARE_COUNT>, SQUARE_COUNT> BETWEEN;
 extern const std::array<std::array<BB, SQUARE_COUNT + 1>, COLOR_COUNT> PAWN_ATTACKS;
 extern const std::array<std::array<BB, SQUARE_COUNT>, PIECE_COUNT> PSEUDO_ATTACKS;
+
+// Method by which the relevant occupancy of a slider is turned into an index into SLIDER_ATTACKS
+enum class SliderBackend { Magic, Pext };
+
+#ifdef JANKCHESS_NATIVE
+// Native builds target a single CPU, so the backend is fixed at compile time, such that lookups
+// never branch upon it. PEXT is preferred where supported, except on AMD prior to Zen 3, and Hygon,
+// where it is microcoded
+#if defined(__BMI2__) && !defined(__bdver4__) && !defined(__znver1__) && !defined(__znver2__)
+constexpr SliderBackend SLIDER_BACKEND = SliderBackend::Pext;
+#else
+constexpr SliderBackend SLIDER_BACKEND = SliderBackend::Magic;
+#endif
+#else
+// The backend in use, chosen at startup by the capabilities of the CPU
+// PEXT is preferred where supported, except on AMD prior to Zen 3, and Hygon, where it is
+// microcoded
+extern SliderBackend SLIDER_BACKEND;
+#endif
+
+// Returns whether the given backend may be used, which for native builds is only the one compiled
+// in, and otherwise those the CPU is able to run
+bool SliderBackendSupported(SliderBackend backend);
+// Switches backend, rebuilding SLIDER_ATTACKS accordingly
+// Returns false, without changing anything, if the backend is unsupported
+// Not thread-safe, so it must not be called while any other thread may look up slider attacks
+bool SetSliderBackend(SliderBackend backend);
+// Returns the name of a backend, i.e. "magic" or "pext"
+const char *SliderBackendName(SliderBackend backend);
+
+// Magic bitboard entry of a slider on a given square
+// Maps the relevant occupancy (mask) to an index into SLIDER_ATTACKS
+struct Magic {
+    BB mask;
+    BB magic;
+    size_t offset;
+    int shift;
+
+    // Resolved at compile time in native builds
+    size_t Index(BB occ) const {
+#if defined(__x86_64__)
+        if (SLIDER_BACKEND == SliderBackend::Pext) return offset + pext(occ, mask);
+#endif
+        return offset + (((occ & mask) * magic) >> shift);
+    }
+};
+
+// Number of attack sets stored for bishops and rooks respectively
+constexpr size_t BISHOP_ATTACK_COUNT = 5248;
+constexpr size_t ROOK_ATTACK_COUNT   = 102400;
+constexpr size_t SLIDER_ATTACK_COUNT = BISHOP_ATTACK_COUNT + ROOK_ATTACK_COUNT;
+
+extern const std::array<Magic, SQUARE_COUNT> BISHOP_MAGICS;
+extern const std::array<Magic, SQUARE_COUNT> ROOK_MAGICS;
+// Filled in at startup, before main is entered, according to SLIDER_BACKEND
+extern std::array<BB, SLIDER_ATTACK_COUNT> SLIDER_ATTACKS;
+
+// Returns the squares attacked by a bishop on sq, given the occupancy
+inline BB BishopAttacks(Square sq, BB occ) { return SLIDER_ATTACKS[BISHOP_MAGICS[sq].Index(occ)]; }
+// Returns the squares attacked by a rook on sq, given the occupancy
+inline BB RookAttacks(Square sq, BB occ) { return SLIDER_ATTACKS[ROOK_MAGICS[sq].Index(occ)]; }
 } // namespace Chess
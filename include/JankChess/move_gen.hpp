@@ -2,6 +2,8 @@
 
 #include <JankChess/board.hpp>
 #include <JankChess/move.hpp>
+#include <JankChess/move_visit.hpp>
+#include <JankChess/position.hpp>
 #include <JankChess/types.hpp>
 #include <algorithm>
 
@@ -11,6 +13,7 @@ public:
     size_t size() const { return move_count; }
     void operator<<(Move move) { moves[move_count++] = move; }
     Move operator[](size_t i) const { return moves[i]; }
+    Move &operator[](size_t i) { return moves[i]; }
     std::array<Move, MAX_MOVES>::iterator begin() { return &moves[0]; }
     std::array<Move, MAX_MOVES>::const_iterator begin() const { return &moves[0]; }
     std::array<Move, MAX_MOVES>::iterator end() { return &moves[size()]; }
@@ -26,4 +29,15 @@ void GenerateMovesQuiet(MoveList &moves, const Board &board, Color color) noexce
 void GenerateMovesTactical(MoveList &moves, const Board &board, Color color) noexcept;
 void GenerateMovesAll(MoveList &moves, const Board &board, Color color) noexcept;
 MoveList GenerateMovesAll(const Board &board, Color color) noexcept;
+// Returns whether the move is among those GenerateMovesAll would generate for the side to move,
+// e.g. to validate a move from the transposition table before it is applied
+bool IsPseudoLegal(const Board &board, Move move) noexcept;
+// Generates strictly legal moves, i.e. none of which leave the king of color in check
+void GenerateMovesLegal(MoveList &moves, const Board &board, Color color) noexcept;
+void GenerateMovesLegal(MoveList &moves, const Position &position, Color color) noexcept;
+MoveList GenerateMovesLegal(const Board &board, Color color) noexcept;
+MoveList GenerateMovesLegal(const Position &position, Color color) noexcept;
+// Returns the number of legal moves, without generating them
+size_t CountMovesLegal(const Board &board, Color color) noexcept;
+size_t CountMovesLegal(const Position &position, Color color) noexcept;
 } // namespace Chess
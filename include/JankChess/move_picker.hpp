@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/move.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/types.hpp>
+#include <array>
+
+namespace Chess {
+// Yields the pseudo-legal moves of the side to move in stages, generating each stage only once the
+// prior is exhausted, as most nodes of a search are cut off after their first move or two
+// The stages are: the hash move, captures by most valuable victim then least valuable attacker,
+// killers, quiet moves, and lastly captures losing material by static exchange evaluation.
+// A hash move or killer is skipped unless pseudo-legal on the board.
+class MovePicker {
+public:
+    MovePicker(
+        const Board &board, Move hash_move = Move(), std::array<Move, 2> killers = {}
+    ) noexcept;
+    // Creates a picker yielding only captures which do not lose material, e.g. for quiescence
+    // search
+    static MovePicker Tactical(const Board &board) noexcept;
+
+    // Returns the next move, or an undefined move once all have been yielded
+    Move Next() noexcept;
+
+private:
+    enum class Stage {
+        HashMove,
+        GenerateCaptures,
+        Captures,
+        Killers,
+        GenerateQuiets,
+        Quiets,
+        BadCaptures,
+        Done
+    };
+
+    const Board &board;
+    Move hash_move;
+    std::array<Move, 2> killers;
+    Stage stage = Stage::HashMove;
+    // Captures, followed by quiet moves once generated
+    // Captures losing material are moved to the front as they are deferred, as the moves before
+    // index have already been yielded
+    MoveList moves;
+    std::array<int, MAX_MOVES> scores;
+    size_t index        = 0;
+    size_t killer_index = 0;
+    size_t bad_count    = 0;
+    bool tactical_only  = false;
+
+    // Returns the remaining capture with the highest score, moving it out of the way
+    Move PickBestCapture() noexcept;
+};
+} // namespace Chess
@@ -0,0 +1,416 @@
+#pragma once
+
+#include <JankChess/bb.hpp>
+#include <JankChess/board.hpp>
+#include <JankChess/instrument.hpp>
+#include <JankChess/masks.hpp>
+#include <JankChess/move.hpp>
+#include <JankChess/position.hpp>
+#include <JankChess/types.hpp>
+#include <concepts>
+#include <utility>
+
+namespace Chess {
+// Move generation by visitors, which are handed each move as it is generated, rather than the
+// moves being collected into a list first
+//
+// A visitor is a functor taking a move, which returns false to stop generation early. If it is also
+// callable with an origin, a bitboard of targets, and a move type, the moves of pieces other than
+// pawns are handed to it in such groups instead, e.g. such that they may be counted by popcount.
+// Pawn and castling moves are always handed over one at a time.
+template <typename V>
+concept MoveVisitor = std::predicate<V &, Move>;
+template <typename V>
+concept MoveGroupVisitor = MoveVisitor<V> && std::predicate<V &, Square, BB, Move::Type>;
+
+// Building blocks of the generators below, which are not part of the interface
+namespace detail {
+// Hands the moves from ori onto each of targets to the visitor
+// Returns false if the visitor stopped generation
+template <MoveVisitor V>
+bool VisitMoves(V &visitor, Square ori, BB targets, Move::Type type) noexcept {
+    if constexpr (MoveGroupVisitor<V>)
+        return !targets || visitor(ori, targets, type);
+    else {
+        while (targets)
+            if (!visitor(Move(ori, lsb_pop(targets), type))) return false;
+        return true;
+    }
+}
+
+// Hands pawn moves onto targets, from delta squares behind each, to the visitor
+template <MoveVisitor V>
+bool VisitPawnMoves(V &visitor, BB targets, int delta, Move::Type type) noexcept {
+    while (targets) {
+        const Square dst = lsb_pop(targets);
+        const Square ori = static_cast<Square>(dst - delta);
+        if (!visitor(Move(ori, dst, type))) return false;
+    }
+    return true;
+}
+
+template <MoveVisitor V>
+bool VisitPromotionMoves(V &visitor, BB targets, int delta, bool capture) noexcept {
+    return VisitPawnMoves(visitor, targets, delta, (Move::Type)(Move::NPromotion + 4 * capture)) &&
+           VisitPawnMoves(visitor, targets, delta, (Move::Type)(Move::BPromotion + 4 * capture)) &&
+           VisitPawnMoves(visitor, targets, delta, (Move::Type)(Move::RPromotion + 4 * capture)) &&
+           VisitPawnMoves(visitor, targets, delta, (Move::Type)(Move::QPromotion + 4 * capture));
+}
+
+// The rank upon which pawns of Us promote
+template <Color Us> constexpr BB PROMOTED_RANK = Us == WHITE ? RANK_8 : RANK_1;
+
+// Returns the destinations of single and double pawn pushes onto empty squares, which land on
+// targets
+template <Color Us>
+std::pair<BB, BB> PawnPushes(BB pawns, BB empty, BB targets) noexcept {
+    constexpr BB ADVANCED_ONCE = Us == WHITE ? RANK_3 : RANK_6;
+
+    const BB advanced       = shift_up<Us>(pawns) & empty;
+    const BB advanced_twice = shift_up<Us>(advanced & ADVANCED_ONCE) & empty & targets;
+    return {advanced & targets, advanced_twice};
+}
+
+// Returns the destinations of left and right pawn captures onto targets
+// Left and right from the perspective of white
+template <Color Us>
+std::pair<BB, BB> PawnCaptures(BB pawns, BB targets) noexcept {
+    constexpr Direction LEFT  = Us == WHITE ? NORTH_WEST : SOUTH_WEST;
+    constexpr Direction RIGHT = Us == WHITE ? NORTH_EAST : SOUTH_EAST;
+
+    const BB left_capture  = targets & shift<LEFT>(pawns) & ~FILE_H;
+    const BB right_capture = targets & shift<RIGHT>(pawns) & ~FILE_A;
+    return {left_capture, right_capture};
+}
+
+// Visits pushes of pawns onto empty squares, keeping only those which land on targets
+template <Color Us, MoveVisitor V>
+bool VisitPawnQuiet(V &visitor, BB pawns, BB empty, BB targets) noexcept {
+    constexpr int DELTA = Us == WHITE ? 8 : -8;
+
+    auto [advanced, advanced_twice] = PawnPushes<Us>(pawns, empty, targets);
+    const BB promoted               = advanced & PROMOTED_RANK<Us>;
+    advanced                        = advanced ^ promoted;
+
+    return VisitPawnMoves(visitor, advanced, DELTA, Move::Quiet) &&
+           VisitPawnMoves(visitor, advanced_twice, 2 * DELTA, Move::DoublePawnPush) &&
+           VisitPromotionMoves(visitor, promoted, DELTA, false);
+}
+
+template <Color Us, MoveVisitor V>
+bool VisitPawnTactical(V &visitor, BB pawns, BB nus, Square ep) noexcept {
+    constexpr int LEFT_DELTA  = Us == WHITE ? 7 : -9;
+    constexpr int RIGHT_DELTA = Us == WHITE ? 9 : -7;
+
+    auto [left_capture, right_capture] = PawnCaptures<Us>(pawns, nus);
+    const BB left_promotion            = left_capture & PROMOTED_RANK<Us>;
+    const BB right_promotion           = right_capture & PROMOTED_RANK<Us>;
+    left_capture                       = left_capture ^ left_promotion;
+    right_capture                      = right_capture ^ right_promotion;
+
+    if (!VisitPawnMoves(visitor, left_capture, LEFT_DELTA, Move::Capture) ||
+        !VisitPawnMoves(visitor, right_capture, RIGHT_DELTA, Move::Capture) ||
+        !VisitPromotionMoves(visitor, left_promotion, LEFT_DELTA, true) ||
+        !VisitPromotionMoves(visitor, right_promotion, RIGHT_DELTA, true))
+        return false;
+
+    BB ep_pawns = PAWN_ATTACKS[!Us][ep] & pawns;
+    while (ep_pawns) [[unlikely]]
+        if (!visitor(Move(lsb_pop(ep_pawns), ep, Move::EPCapture))) return false;
+    return true;
+}
+
+template <MoveVisitor V>
+bool VisitJumperMoves(
+    V &visitor, const std::array<BB, SQUARE_COUNT> &attacks, BB pieces, BB targets,
+    Move::Type type
+) noexcept {
+    while (pieces) {
+        const Square ori = lsb_pop(pieces);
+        if (!VisitMoves(visitor, ori, attacks[ori] & targets, type)) return false;
+    }
+    return true;
+}
+
+template <MoveVisitor V>
+bool VisitSliderMoves(
+    V &visitor, BB (*attacks)(Square, BB), BB pieces, BB targets, BB occ, Move::Type type
+) noexcept {
+    while (pieces) {
+        const Square piece = lsb_pop(pieces);
+        if (!VisitMoves(visitor, piece, attacks(piece, occ) & targets, type)) return false;
+    }
+    return true;
+}
+
+constexpr Square KING_POS[2]         = {E1, E8};
+constexpr Square KING_CASTLE_POS[2]  = {G1, G8};
+constexpr Square QUEEN_CASTLE_POS[2] = {C1, C8};
+constexpr BB KING_BLOCKERS[2]        = {ToBB(F1) | G1, ToBB(F8) | G8};
+constexpr BB QUEEN_BLOCKERS[2]       = {ToBB(B1) | C1 | D1, ToBB(B8) | C8 | D8};
+constexpr BB QUEEN_ATTACKERS[2]      = {ToBB(C1) | D1, ToBB(C8) | D8};
+
+// Returns the sides upon which castling is legal, where attacks are the squares attacked by the
+// opponent
+template <Color Us>
+Castling LegalCastling(Castling castling, BB occ, BB attacks) noexcept {
+    if (attacks & KING_POS[Us]) return Castling::None;
+    if ((occ | attacks) & KING_BLOCKERS[Us]) castling &= Castling::Queen;
+    if ((occ & QUEEN_BLOCKERS[Us]) || (attacks & QUEEN_ATTACKERS[Us])) castling &= Castling::King;
+    return castling;
+}
+
+// Visits castling moves, where attacks are the squares attacked by the opponent
+template <Color Us, MoveVisitor V>
+bool VisitCastlingMoves(V &visitor, Castling castling, BB occ, BB attacks) noexcept {
+    castling = LegalCastling<Us>(castling, occ, attacks);
+    if ((bool)(castling & Castling::King) &&
+        !visitor(Move(KING_POS[Us], KING_CASTLE_POS[Us], Move::KingCastle)))
+        return false;
+    if ((bool)(castling & Castling::Queen) &&
+        !visitor(Move(KING_POS[Us], QUEEN_CASTLE_POS[Us], Move::QueenCastle)))
+        return false;
+    return true;
+}
+
+template <Color Us, MoveVisitor V>
+bool VisitQuiet(V &visitor, const Board &board) noexcept {
+    const BB occ   = board.Pieces();
+    const BB empty = ~occ;
+
+    const BB pawns   = board.Pieces(Us, PAWN);
+    const BB knights = board.Pieces(Us, KNIGHT);
+    const BB kings   = board.Pieces(Us, KING);
+    const BB bishops = board.Pieces(Us, BISHOP) | board.Pieces(Us, QUEEN);
+    const BB rooks   = board.Pieces(Us, ROOK) | board.Pieces(Us, QUEEN);
+
+    if (!VisitPawnQuiet<Us>(visitor, pawns, empty, empty) ||
+        !VisitSliderMoves(visitor, BishopAttacks, bishops, empty, occ, Move::Quiet) ||
+        !VisitSliderMoves(visitor, RookAttacks, rooks, empty, occ, Move::Quiet) ||
+        !VisitJumperMoves(visitor, PSEUDO_ATTACKS[KNIGHT], knights, empty, Move::Quiet) ||
+        !VisitJumperMoves(visitor, PSEUDO_ATTACKS[KING], kings, empty, Move::Quiet))
+        return false;
+
+    // Attacks are costly to generate, unless maintained by the board, so only do so if castling is
+    // otherwise possible
+    const Castling castling = board.GetCastling(Us);
+    if (((bool)(castling & Castling::King) && !(occ & KING_BLOCKERS[Us])) ||
+        ((bool)(castling & Castling::Queen) && !(occ & QUEEN_BLOCKERS[Us]))) {
+        JANKCHESS_ZONE("GenerateCastlingMoves");
+        JANKCHESS_COUNT(COUNTER_CASTLING_ATTACKS);
+        return VisitCastlingMoves<Us>(visitor, castling, occ, board.Attacks(!Us));
+    }
+    return true;
+}
+
+template <Color Us, MoveVisitor V>
+bool VisitTactical(V &visitor, const Board &board) noexcept {
+    const BB nus = board.Pieces(!Us);
+    const BB occ = board.Pieces();
+
+    const BB pawns   = board.Pieces(Us, PAWN);
+    const BB knights = board.Pieces(Us, KNIGHT);
+    const BB kings   = board.Pieces(Us, KING);
+    const BB bishops = board.Pieces(Us, BISHOP) | board.Pieces(Us, QUEEN);
+    const BB rooks   = board.Pieces(Us, ROOK) | board.Pieces(Us, QUEEN);
+
+    return VisitPawnTactical<Us>(visitor, pawns, nus, board.EP()) &&
+           VisitSliderMoves(visitor, BishopAttacks, bishops, nus, occ, Move::Capture) &&
+           VisitSliderMoves(visitor, RookAttacks, rooks, nus, occ, Move::Capture) &&
+           VisitJumperMoves(visitor, PSEUDO_ATTACKS[KNIGHT], knights, nus, Move::Capture) &&
+           VisitJumperMoves(visitor, PSEUDO_ATTACKS[KING], kings, nus, Move::Capture);
+}
+
+// Per-position masks from which only legal moves are generated
+struct LegalMasks {
+    Square king;
+    // Squares attacked by the opponent if the king were absent, such that it cannot step back
+    // along the ray of a slider checking it
+    BB danger;
+    BB checkers;
+    // Pieces which are the sole blocker between the king and an opposing slider
+    BB pinned;
+    // Squares upon which a move other than by the king may capture or move quietly
+    // Restricted to those resolving a check, by capturing the checker or blocking it
+    BB captures;
+    BB quiets;
+};
+
+template <Color Us, typename B>
+LegalMasks ComputeLegalMasks(const B &board) noexcept {
+    constexpr Color Them = !Us;
+    LegalMasks masks;
+    const Square king = lsb(board.Pieces(Us, KING));
+    const BB occ      = board.Pieces();
+
+    const BB nus_bishops = board.Pieces(Them, BISHOP) | board.Pieces(Them, QUEEN);
+    const BB nus_rooks   = board.Pieces(Them, ROOK) | board.Pieces(Them, QUEEN);
+
+    masks.king     = king;
+    masks.checkers = (PAWN_ATTACKS[Us][king] & board.Pieces(Them, PAWN)) |
+                     (PSEUDO_ATTACKS[KNIGHT][king] & board.Pieces(Them, KNIGHT)) |
+                     (BishopAttacks(king, occ) & nus_bishops) |
+                     (RookAttacks(king, occ) & nus_rooks);
+#ifdef JANKCHESS_ATTACK_MAPS
+    if constexpr (std::same_as<B, Board>) {
+        // The maintained attacks stop at the king, so only sliders checking it see past
+        masks.danger = board.Attacks(Them);
+        BB sliders   = masks.checkers & (nus_bishops | nus_rooks);
+        while (sliders) {
+            const Square slider = lsb_pop(sliders);
+            if (nus_bishops & slider) masks.danger |= BishopAttacks(slider, occ ^ king);
+            if (nus_rooks & slider) masks.danger |= RookAttacks(slider, occ ^ king);
+        }
+    } else
+#endif
+        masks.danger = board.GenerateAttacks(Them, occ ^ king);
+
+    const BB check_mask =
+        masks.checkers ? (BETWEEN[king][lsb(masks.checkers)] | masks.checkers) : ~0ULL;
+    masks.captures = board.Pieces(Them) & check_mask;
+    masks.quiets   = ~occ & check_mask;
+
+    masks.pinned = 0;
+    BB pinners   = (PSEUDO_ATTACKS[BISHOP][king] & nus_bishops) |
+                 (PSEUDO_ATTACKS[ROOK][king] & nus_rooks);
+    while (pinners) {
+        const BB blockers = BETWEEN[king][lsb_pop(pinners)] & occ;
+        if (popcount(blockers) == 1) masks.pinned |= blockers & board.Pieces(Us);
+    }
+
+    return masks;
+}
+
+// Returns the squares a pinned bishop, rook, or queen may move to, being those along the pin
+template <typename B>
+BB PinnedSliderTargets(const B &board, Square king, Square piece) noexcept {
+    const BB occ = board.Pieces();
+    const BB ray = SQ_RAYS[king][piece];
+
+    switch (board.SquarePiece(piece)) {
+    case BISHOP: return BishopAttacks(piece, occ) & ray;
+    case ROOK: return RookAttacks(piece, occ) & ray;
+    case QUEEN: return (BishopAttacks(piece, occ) | RookAttacks(piece, occ)) & ray;
+    default: return 0;
+    }
+}
+
+// Returns the pawns which may capture en passant without leaving the king in check
+// These are validated by occupancy after the capture, as two pieces leave the pawns' rank at once
+template <Color Us, typename B>
+BB LegalEPPawns(const B &board, Square king, BB pawns, BB checkers) noexcept {
+    constexpr Color Them = !Us;
+    const Square ep      = board.EP();
+    if (ep == SQUARE_NONE) return 0;
+
+    const Square captured = static_cast<Square>(ep + (Us == WHITE ? -8 : 8));
+    const BB bishops      = board.Pieces(Them, BISHOP) | board.Pieces(Them, QUEEN);
+    const BB rooks        = board.Pieces(Them, ROOK) | board.Pieces(Them, QUEEN);
+
+    // A knight, or pawn other than the captured, giving check cannot be resolved by en passant
+    if (checkers & ~(bishops | rooks) & ~ToBB(captured)) return 0;
+
+    BB legal    = 0;
+    BB ep_pawns = PAWN_ATTACKS[Them][ep] & pawns;
+    while (ep_pawns) {
+        const Square ori = lsb_pop(ep_pawns);
+        const BB occ     = (board.Pieces() ^ ori ^ captured) | ep;
+        if (BishopAttacks(king, occ) & bishops) continue;
+        if (RookAttacks(king, occ) & rooks) continue;
+        legal |= ori;
+    }
+    return legal;
+}
+
+// Shared by boards and positions, which expose the same accessors
+template <Color Us, typename B, MoveVisitor V>
+bool VisitLegal(V &visitor, const B &board) noexcept {
+    constexpr Color Them   = !Us;
+    const LegalMasks masks = ComputeLegalMasks<Us>(board);
+    const Square king      = masks.king;
+    const BB occ           = board.Pieces();
+    const BB empty         = ~occ;
+
+    const BB king_targets = PSEUDO_ATTACKS[KING][king] & ~masks.danger;
+    if (!VisitMoves(visitor, king, king_targets & board.Pieces(Them), Move::Capture) ||
+        !VisitMoves(visitor, king, king_targets & empty, Move::Quiet))
+        return false;
+
+    // In double check only the king may move
+    if (popcount(masks.checkers) > 1) return true;
+
+    const BB pawns   = board.Pieces(Us, PAWN);
+    const BB free    = ~masks.pinned;
+    const BB knights = board.Pieces(Us, KNIGHT) & free;
+    const BB bishops = (board.Pieces(Us, BISHOP) | board.Pieces(Us, QUEEN)) & free;
+    const BB rooks   = (board.Pieces(Us, ROOK) | board.Pieces(Us, QUEEN)) & free;
+
+    const BB captures = masks.captures;
+    const BB quiets   = masks.quiets;
+    if (!VisitPawnTactical<Us>(visitor, pawns & free, captures, SQUARE_NONE) ||
+        !VisitPawnQuiet<Us>(visitor, pawns & free, empty, quiets) ||
+        !VisitSliderMoves(visitor, BishopAttacks, bishops, captures, occ, Move::Capture) ||
+        !VisitSliderMoves(visitor, BishopAttacks, bishops, quiets, occ, Move::Quiet) ||
+        !VisitSliderMoves(visitor, RookAttacks, rooks, captures, occ, Move::Capture) ||
+        !VisitSliderMoves(visitor, RookAttacks, rooks, quiets, occ, Move::Quiet) ||
+        !VisitJumperMoves(visitor, PSEUDO_ATTACKS[KNIGHT], knights, captures, Move::Capture) ||
+        !VisitJumperMoves(visitor, PSEUDO_ATTACKS[KNIGHT], knights, quiets, Move::Quiet))
+        return false;
+
+    BB ep_pawns = LegalEPPawns<Us>(board, king, pawns, masks.checkers);
+    while (ep_pawns) [[unlikely]]
+        if (!visitor(Move(lsb_pop(ep_pawns), board.EP(), Move::EPCapture))) return false;
+
+    // Pinned pieces may only move along the ray between their king and the pinner
+    for (BB pinned = masks.pinned & ~board.Pieces(KNIGHT); pinned;) {
+        const Square piece = lsb_pop(pinned);
+        const BB ray       = SQ_RAYS[king][piece];
+        if (piece & pawns) {
+            if (!VisitPawnTactical<Us>(visitor, ToBB(piece), captures & ray, SQUARE_NONE) ||
+                !VisitPawnQuiet<Us>(visitor, ToBB(piece), empty, quiets & ray))
+                return false;
+        } else {
+            const BB targets = PinnedSliderTargets(board, king, piece);
+            if (!VisitMoves(visitor, piece, targets & captures, Move::Capture) ||
+                !VisitMoves(visitor, piece, targets & quiets, Move::Quiet))
+                return false;
+        }
+    }
+
+    if (!masks.checkers)
+        return VisitCastlingMoves<Us>(visitor, board.GetCastling(Us), occ, masks.danger);
+    return true;
+}
+} // namespace detail
+
+// Visits the quiet moves of color, being those which capture nothing, including promotions
+// Returns false if the visitor stopped generation
+template <MoveVisitor V>
+bool VisitMovesQuiet(const Board &board, Color color, V &&visitor) noexcept {
+    return color == WHITE ? detail::VisitQuiet<WHITE>(visitor, board)
+                          : detail::VisitQuiet<BLACK>(visitor, board);
+}
+// Visits the captures of color, including capturing promotions and en passant
+template <MoveVisitor V>
+bool VisitMovesTactical(const Board &board, Color color, V &&visitor) noexcept {
+    return color == WHITE ? detail::VisitTactical<WHITE>(visitor, board)
+                          : detail::VisitTactical<BLACK>(visitor, board);
+}
+// Visits the captures, then quiet moves, of color
+template <MoveVisitor V>
+bool VisitMovesAll(const Board &board, Color color, V &&visitor) noexcept {
+    if (color == WHITE)
+        return detail::VisitTactical<WHITE>(visitor, board) &&
+               detail::VisitQuiet<WHITE>(visitor, board);
+    else
+        return detail::VisitTactical<BLACK>(visitor, board) &&
+               detail::VisitQuiet<BLACK>(visitor, board);
+}
+// Visits strictly legal moves, i.e. none of which leave the king of color in check
+// Board may be either a board or a position
+template <typename B, MoveVisitor V>
+bool VisitMovesLegal(const B &board, Color color, V &&visitor) noexcept {
+    return color == WHITE ? detail::VisitLegal<WHITE>(visitor, board)
+                          : detail::VisitLegal<BLACK>(visitor, board);
+}
+} // namespace Chess
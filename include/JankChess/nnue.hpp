@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JankChess/types.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chess {
+class Board;
+
+// One input per piece of each color on each square, as seen by a perspective
+#define NNUE_INPUTS (COLOR_COUNT * PIECE_COUNT * SQUARE_COUNT)
+// Width of the hidden layer of each perspective
+#define NNUE_HIDDEN 128
+
+// Quantisation of the hidden layer, whose activations are clipped to [0, NNUE_QA]
+constexpr int NNUE_QA = 255;
+// Quantisation of the output weights
+constexpr int NNUE_QB = 64;
+// Centipawns of an output of one
+constexpr int NNUE_SCALE = 400;
+
+// A network of (768 -> 128) x 2 -> 1, where the hidden layer is computed once for each perspective,
+// with the side to move first, and activated by a clipped ReLU
+//
+// The hidden layer is quantised by NNUE_QA, and the output layer by NNUE_QB
+// Weights are stored on disk as little-endian int16 in declaration order, with nothing else
+struct Network {
+    alignas(64) std::array<std::array<int16_t, NNUE_HIDDEN>, NNUE_INPUTS> feature_weights;
+    alignas(64) std::array<int16_t, NNUE_HIDDEN> feature_bias;
+    alignas(64) std::array<int16_t, 2 * NNUE_HIDDEN> output_weights;
+    int16_t output_bias;
+
+    // Reads a network from a file, returning nullptr if it cannot be read or is of the wrong size
+    static std::unique_ptr<Network> Load(const std::string &path);
+};
+
+// Returns the name of the kernels compiled in, i.e. "avx2", "sse2" or "scalar"
+const char *NNUEKernelName();
+
+// The hidden layer of a position, before activation, from the perspective of each color
+struct alignas(64) Accumulator {
+    std::array<std::array<int16_t, NNUE_HIDDEN>, COLOR_COUNT> values;
+};
+
+// Accumulators of each ply of a board, such that undoing a move only requires returning to the
+// accumulator of the prior ply
+// Like the undo information of the board, only the last MAX_PLY plies are kept
+// Attached to a board by Board::AttachAccumulators, after which the board keeps it up to date
+class AccumulatorStack {
+public:
+    explicit AccumulatorStack(std::shared_ptr<const Network> network);
+
+    // Computes the accumulator of ply from the pieces of board
+    void Refresh(const Board &board, size_t ply) noexcept;
+    // Starts the accumulator of ply as a copy of the one before it
+    void Push(size_t ply) noexcept;
+    // Updates the accumulator of ply by a piece of color being added to, or removed from, square
+    void Add(size_t ply, Color color, Piece piece, Square square) noexcept;
+    void Remove(size_t ply, Color color, Piece piece, Square square) noexcept;
+    // Returns the evaluation of the position of ply in centipawns, from the perspective of turn
+    int Evaluate(size_t ply, Color turn) const noexcept;
+    const Accumulator &operator[](size_t ply) const noexcept;
+
+private:
+    std::shared_ptr<const Network> network;
+    std::vector<Accumulator> accumulators;
+};
+} // namespace Chess
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace Chess {
+// Hardware events which may be counted around a section of code
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_NONE
+};
+#define PERF_EVENT_COUNT 5
+
+// The name of each event, as printed per node
+constexpr std::array<const char *, PERF_EVENT_COUNT> PERF_EVENT_NAMES = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"
+};
+
+// Counts of each event over a section, where those the host could not count are left invalid
+struct PerfCounts {
+    std::array<uint64_t, PERF_EVENT_COUNT> counts = {};
+    std::array<bool, PERF_EVENT_COUNT> valid      = {};
+};
+
+// Counts hardware events through perf_event_open, in user space, from Start until Stop
+// Events are counted for the calling thread and every thread it creates afterwards, which are
+// included once they have been joined. Only built with JANKCHESS_PERF_COUNTERS, and otherwise no
+// event is ever opened, and each call compiles to nothing.
+class PerfCounters {
+public:
+#ifdef JANKCHESS_PERF_COUNTERS
+    PerfCounters() noexcept;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters &)            = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Whether any event could be opened
+    bool Available() const noexcept;
+    // Resets and enables every event
+    void Start() noexcept;
+    // Disables every event, returning their counts since Start, scaled up if multiplexed
+    PerfCounts Stop() noexcept;
+
+private:
+    std::array<int, PERF_EVENT_COUNT> fds;
+#else
+    constexpr bool Available() const noexcept { return false; }
+    constexpr void Start() noexcept {}
+    constexpr PerfCounts Stop() noexcept { return {}; }
+#endif
+};
+
+// Writes each valid count divided by operations, then the instructions per cycle, each preceded by
+// a space and ending the line
+void PrintPerfCounts(FILE *file, const PerfCounts &counts, size_t operations, const char *unit);
+} // namespace Chess
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/move_visit.hpp>
+#include <JankChess/position.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Chess {
+// Counts of the nodes a number of plies below a position, by which move generation is verified
+
+// A table of subtree node counts, which is probed before a subtree is counted and stored to after
+template <typename C>
+concept SubtreeCache = requires(C &cache, Hash hash, int depth, size_t nodes) {
+    { cache.Probe(hash, depth) } -> std::same_as<std::optional<size_t>>;
+    cache.Store(hash, depth, nodes);
+};
+
+// Caches nothing, such that every subtree is counted
+struct NoSubtreeCache {
+    std::optional<size_t> Probe(Hash, int) const noexcept { return std::nullopt; }
+    void Store(Hash, int, size_t) const noexcept {}
+};
+
+// Subtrees shallower than this are cheaper to count than to look up, so are never cached
+#define PERFT_CACHE_MIN_DEPTH 2
+
+// Lockless table of subtree node counts, which may be shared by threads
+// An entry stores its key xor'ed with its data beside the data, such that an entry torn by racing
+// writes fails validation rather than returning a wrong count
+class PerftCache {
+public:
+    // Creates a table of the most entries, being a power of two, which fit within bytes
+    explicit PerftCache(size_t bytes)
+        : entries(std::bit_floor(std::max<size_t>(1, bytes / sizeof(Entry)))),
+          mask(entries.size() - 1) {}
+
+    std::optional<size_t> Probe(Hash hash, int depth) const {
+        if (depth < PERFT_CACHE_MIN_DEPTH) return std::nullopt;
+        const Entry &entry  = entries[hash & mask];
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) != hash) return std::nullopt;
+        if (static_cast<int>(data & 0xff) != depth) return std::nullopt;
+        return data >> 8;
+    }
+    // Replaces whichever entry the hash maps to
+    void Store(Hash hash, int depth, size_t nodes) {
+        if (depth < PERFT_CACHE_MIN_DEPTH) return;
+        Entry &entry        = entries[hash & mask];
+        const uint64_t data = (static_cast<uint64_t>(nodes) << 8) | depth;
+        entry.check.store(hash ^ data, std::memory_order_relaxed);
+        entry.data.store(data, std::memory_order_relaxed);
+    }
+    size_t Size() const noexcept { return entries.size(); }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    std::vector<Entry> entries;
+    size_t mask;
+};
+
+// Consults a cache shared by threads, each of which holds its own copy, as by PerftParallel
+template <SubtreeCache C>
+struct SharedSubtreeCache {
+    C *cache;
+    std::optional<size_t> Probe(Hash hash, int depth) { return cache->Probe(hash, depth); }
+    void Store(Hash hash, int depth, size_t nodes) { cache->Store(hash, depth, nodes); }
+};
+
+// Counts nodes depth plies below board, where every ply is applied
+template <SubtreeCache C>
+size_t Perft(Board &board, int depth, C &cache) {
+    if (depth == 0) return 1;
+    if (const auto cached = cache.Probe(board.GetHash(), depth)) return *cached;
+    MoveList moves;
+    GenerateMovesLegal(moves, board, board.Turn());
+
+    size_t nodes = 0;
+
+    for (const auto &move : moves) {
+        board.ApplyMove(move);
+        nodes += Perft(board, depth - 1, cache);
+        board.UndoMove(move);
+    }
+
+    cache.Store(board.GetHash(), depth, nodes);
+    return nodes;
+}
+
+// Same as Perft, however, the last ply is counted rather than applied
+template <SubtreeCache C>
+size_t PerftBulk(Board &board, int depth, C &cache) {
+    if (depth == 0) return 1;
+    if (depth == 1) return CountMovesLegal(board, board.Turn());
+    if (const auto cached = cache.Probe(board.GetHash(), depth)) return *cached;
+    MoveList moves;
+    GenerateMovesLegal(moves, board, board.Turn());
+
+    size_t nodes = 0;
+
+    for (const auto &move : moves) {
+        board.ApplyMove(move);
+        nodes += PerftBulk(board, depth - 1, cache);
+        board.UndoMove(move);
+    }
+
+    cache.Store(board.GetHash(), depth, nodes);
+    return nodes;
+}
+
+// Same as Perft, or PerftBulk if bulk, however, by copy-make of positions rather than make/unmake
+template <SubtreeCache C>
+size_t PerftCopy(const Position &position, int depth, bool bulk, C &cache) {
+    if (depth == 0) return 1;
+    if (bulk && depth == 1) return CountMovesLegal(position, position.Turn());
+    if (const auto cached = cache.Probe(position.GetHash(), depth)) return *cached;
+
+    size_t nodes = 0;
+
+    // Positions are left untouched by moves, so each is searched as soon as it is generated
+    VisitMovesLegal(position, position.Turn(), [&](Move move) {
+        nodes += PerftCopy(position.Apply(move), depth - 1, bulk, cache);
+        return true;
+    });
+
+    cache.Store(position.GetHash(), depth, nodes);
+    return nodes;
+}
+
+// Same as Perft, or PerftBulk if bulk, where copy is whether to copy-make positions
+template <SubtreeCache C>
+size_t PerftAny(Board &board, int depth, bool bulk, bool copy, C &cache) {
+    if (copy) return PerftCopy(Position(board), depth, bulk, cache);
+    return bulk ? PerftBulk(board, depth, cache) : Perft(board, depth, cache);
+}
+
+namespace detail {
+// A subtree to be counted, identified by the moves leading to it from the root
+struct PerftTask {
+    size_t root;
+    std::vector<Move> path;
+};
+
+// Tasks of a single worker, which it pops from the back, while others steal from the front
+class PerftTaskQueue {
+public:
+    void Push(PerftTask task) {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    std::optional<PerftTask> Pop() {
+        std::lock_guard lock(mutex);
+        if (tasks.empty()) return std::nullopt;
+        PerftTask task = std::move(tasks.back());
+        tasks.pop_back();
+        return task;
+    }
+    std::optional<PerftTask> Steal() {
+        std::lock_guard lock(mutex);
+        if (tasks.empty()) return std::nullopt;
+        PerftTask task = std::move(tasks.front());
+        tasks.pop_front();
+        return task;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<PerftTask> tasks;
+};
+
+// Expands the tree until split plies below the root, adding each node there as a task
+void SplitPerft(Board &board, int split, PerftTask &task, std::vector<PerftTask> &tasks);
+} // namespace detail
+
+// Counts the nodes depth plies below root after each of moves, which must be legal, distributing
+// the subtrees split plies below the root across threads, which steal from each other once idle
+// Counts are in the order of moves, regardless of which thread finished first
+// Each thread counts through its own copy of cache, so copies must share any table safely
+template <SubtreeCache C>
+std::vector<size_t> PerftParallel(
+    const Board &root, const MoveList &moves, int depth, bool bulk, bool copy, size_t thread_count,
+    int split, const C &cache
+) {
+    assert(depth >= 1);
+    thread_count = std::max<size_t>(thread_count, 1);
+    split        = std::clamp(split, 1, depth);
+
+    std::vector<detail::PerftTask> tasks;
+    Board board = root;
+    for (size_t i = 0; i < moves.size(); i++) {
+        detail::PerftTask task = {i, {moves[i]}};
+        board.ApplyMove(moves[i]);
+        detail::SplitPerft(board, split, task, tasks);
+        board.UndoMove(moves[i]);
+    }
+
+    // Tasks are dealt round robin, such that the subtrees of each root move are spread out
+    std::vector<detail::PerftTaskQueue> queues(thread_count);
+    for (size_t i = 0; i < tasks.size(); i++)
+        queues[i % thread_count].Push(std::move(tasks[i]));
+
+    std::vector<std::atomic<size_t>> nodes(moves.size());
+    std::vector<std::thread> threads;
+    for (size_t id = 0; id < thread_count; id++) {
+        threads.emplace_back([&, id] {
+            Board board = root;
+            C local     = cache;
+            while (true) {
+                std::optional<detail::PerftTask> task = queues[id].Pop();
+                for (size_t i = 1; i < thread_count && !task; i++)
+                    task = queues[(id + i) % thread_count].Steal();
+                // No task spawns others, so once every queue is empty all work is taken
+                if (!task) return;
+
+                for (const auto move : task->path)
+                    board.ApplyMove(move);
+                const int remaining = depth - static_cast<int>(task->path.size());
+                nodes[task->root] += PerftAny(board, remaining, bulk, copy, local);
+                for (auto move = task->path.rbegin(); move != task->path.rend(); move++)
+                    board.UndoMove(*move);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    return std::vector<size_t>(nodes.begin(), nodes.end());
+}
+
+inline size_t Perft(Board &board, int depth) {
+    NoSubtreeCache cache;
+    return Perft(board, depth, cache);
+}
+inline size_t PerftBulk(Board &board, int depth) {
+    NoSubtreeCache cache;
+    return PerftBulk(board, depth, cache);
+}
+inline size_t PerftCopy(const Position &position, int depth, bool bulk) {
+    NoSubtreeCache cache;
+    return PerftCopy(position, depth, bulk, cache);
+}
+inline std::vector<size_t> PerftParallel(
+    const Board &root, const MoveList &moves, int depth, bool bulk, bool copy, size_t thread_count,
+    int split
+) {
+    return PerftParallel(root, moves, depth, bulk, copy, thread_count, split, NoSubtreeCache());
+}
+} // namespace Chess
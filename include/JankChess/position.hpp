@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/move.hpp>
+
+namespace Chess {
+// A compact chess position, spanning two cache lines, intended for copy-make
+// That is, rather than applying and undoing moves on a single instance, each move produces a new
+// position, leaving the prior untouched. As such, it keeps no history.
+class alignas(64) Position {
+public:
+    // CONSTRUCTOR
+
+    // Creates a position equivalent to the current one of board
+    explicit Position(const Board &board) noexcept;
+    // Creates a position equvilant to the given FEN string
+    explicit Position(const std::string &FEN) noexcept;
+
+    // ACCESS
+
+    // Returns the color whose turn it is
+    Color Turn() const noexcept;
+    // Returns the square upon which EP capture is legal
+    // In case that no such square exists, SQUARE_NONE is returned
+    Square EP() const noexcept;
+    // Returns the castling rights of the color
+    Castling GetCastling(Color color) const noexcept;
+    // Returns the position's hash, equal to that of a board in the same position
+    Hash GetHash() const noexcept;
+    // Returns all pieces
+    BB Pieces() const noexcept;
+    // Returns pieces of type
+    BB Pieces(Piece piece) const noexcept;
+    // Returns pieces of color
+    BB Pieces(Color color) const noexcept;
+    // Returns pieces of type and color
+    BB Pieces(Color color, Piece piece) const noexcept;
+    // Returns the type of piece on given square
+    Piece SquarePiece(Square square) const noexcept;
+    // Returns an attack bitboard, where sliders are blocked by occ
+    BB GenerateAttacks(Color color, BB occ) const noexcept;
+
+    // MODIFIERS
+
+    // Returns the position after the move is applied
+    Position Apply(Move move) const noexcept;
+    // Same as Apply, where Us must be the color whose turn it is
+    template <Color Us>
+    Position Apply(Move move) const noexcept;
+
+private:
+    BB pieces[PIECE_COUNT];
+    BB colors[COLOR_COUNT];
+    Hash hash;
+    // Piece of each square, two squares to a byte
+    // Zeroed before packing, as each square is set by masking the byte it shares
+    uint8_t mailbox[SQUARE_COUNT / 2] = {};
+    uint8_t turn;
+    uint8_t ep;
+    // Castling rights of white in the lower two bits, and black in the two above
+    uint8_t castling;
+
+    void SetSquarePiece(Square square, Piece piece) noexcept;
+    void SetCastling(Color color, Castling castling) noexcept;
+    void PlacePiece(Color color, Piece piece, Square square) noexcept;
+    void RemovePiece(Color color, Piece piece, Square square) noexcept;
+};
+static_assert(sizeof(Position) == 128);
+} // namespace Chess
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <JankChess/types.hpp>
+#include <array>
+
+namespace Chess {
+// A pair of midgame and endgame scores in centipawns, from the perspective of white
+struct Score {
+    int mg = 0;
+    int eg = 0;
+
+    constexpr Score operator+(Score other) const { return {mg + other.mg, eg + other.eg}; }
+    constexpr Score operator-(Score other) const { return {mg - other.mg, eg - other.eg}; }
+    constexpr Score operator-() const { return {-mg, -eg}; }
+    constexpr Score &operator+=(Score other) { return *this = *this + other; }
+    constexpr Score &operator-=(Score other) { return *this = *this - other; }
+    constexpr bool operator==(const Score &) const = default;
+};
+
+// Material of each type of piece
+constexpr std::array<Score, PIECE_COUNT> MATERIAL = {
+    Score{82, 94}, Score{337, 281}, Score{365, 297}, Score{477, 512}, Score{1025, 936}, Score{0, 0}
+};
+
+// Contribution of each type of piece to the game phase, which is PHASE_MAX at the start of the game
+// and falls towards zero as pieces are traded
+constexpr std::array<int, PIECE_COUNT> PHASE_WEIGHTS = {0, 1, 1, 2, 4, 0};
+constexpr int PHASE_MAX                              = 24;
+
+// Returns the material and placement of a piece of color on square, where black is negative
+Score PieceSquare(Color color, Piece piece, Square square);
+// Returns the interpolation of a score between midgame and endgame by phase
+// Phases beyond PHASE_MAX, i.e. after early promotions, are treated as PHASE_MAX
+int Taper(Score score, int phase);
+} // namespace Chess
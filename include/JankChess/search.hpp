@@ -0,0 +1,117 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/move.hpp>
+#include <JankChess/nnue.hpp>
+#include <JankChess/tt.hpp>
+#include <JankChess/types.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Chess {
+// Maximum depth of a search in plies, including quiescence
+#define MAX_DEPTH 64
+static_assert(MAX_PLY > MAX_DEPTH, "Boards must be able to undo every move of a search");
+
+// Score of being mated at the root, where being mated n plies later scores n higher
+constexpr int SCORE_MATE     = 32000;
+constexpr int SCORE_INFINITE = SCORE_MATE + 1;
+
+// Returns whether the score is that of a forced mate, for either side
+constexpr bool IsMateScore(int score) { return std::abs(score) >= SCORE_MATE - MAX_DEPTH; }
+
+// Limits upon a search, where zero is no limit
+struct SearchLimits {
+    int depth    = MAX_DEPTH - 1;
+    size_t nodes = 0;
+    // Milliseconds
+    size_t time = 0;
+};
+
+struct SearchResult {
+    Move best_move;
+    // Centipawns from the perspective of the side to move
+    int score = 0;
+    // Depth of the last completed iteration
+    int depth = 0;
+    std::vector<Move> pv;
+    // Summed over all threads
+    size_t nodes = 0;
+    // Milliseconds
+    size_t time = 0;
+    size_t nps  = 0;
+    // Nodes searched by each thread, where the first is the main thread
+    std::vector<size_t> thread_nodes;
+};
+
+// Iterative deepening principal variation search, with a quiescence search of captures at its
+// leaves
+// With several threads the search is lazy SMP, that is, every thread searches the same position
+// on its own board, sharing results only through a lockless transposition table
+class Searcher {
+public:
+    // Creates a searcher with a transposition table of hash_mb megabytes
+    explicit Searcher(size_t hash_mb = 16, size_t thread_count = 1);
+
+    // Searches board until a limit is reached, or Stop is called, returning the result of the
+    // deepest iteration completed by the main thread
+    // If given, on_iteration is called with the result of each completed iteration
+    // Every thread copies the board, sharing its attached history, which is only read
+    SearchResult Search(
+        const Board &board, const SearchLimits &limits,
+        const std::function<void(const SearchResult &)> &on_iteration = {}
+    );
+    // Stops an ongoing search, which may be called from another thread
+    void Stop() noexcept;
+    // Forgets results of prior searches
+    void Clear() noexcept;
+    // Sets the number of threads of subsequent searches, at least one
+    void SetThreads(size_t thread_count);
+    size_t ThreadCount() const noexcept;
+    // Replaces the transposition table with an empty one of hash_mb megabytes
+    void SetHash(size_t hash_mb);
+    // Returns the nodes searched by the ongoing, or last, search, which may be called from another
+    // thread
+    size_t Nodes() const noexcept;
+    // Evaluates subsequent searches by the network, or by material and placement if nullptr
+    void SetNetwork(std::shared_ptr<const Network> network);
+
+private:
+    // State owned by a single thread
+    struct Thread {
+        size_t id;
+        Board board;
+        // Written only by the owning thread, though read by the main thread while searching
+        std::atomic<size_t> nodes;
+        // Zero for no limit
+        size_t node_limit;
+        std::array<std::array<Move, 2>, MAX_DEPTH> killers;
+        // Triangular table, where pv[ply] holds the principal variation from ply onward
+        std::array<std::array<Move, MAX_DEPTH>, MAX_DEPTH> pv;
+        std::array<int, MAX_DEPTH> pv_length;
+        // Attached to board while searching, if there is a network
+        std::unique_ptr<AccumulatorStack> accumulators;
+    };
+
+    TranspositionTable tt;
+    std::shared_ptr<const Network> network;
+    std::vector<Thread> threads;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> stop;
+
+    int AlphaBeta(Thread &thread, int alpha, int beta, int depth, int ply) noexcept;
+    int Quiescence(Thread &thread, int alpha, int beta, int ply) noexcept;
+    // Iterative deepening of a helper thread, until the search is stopped
+    void SearchHelper(Thread &thread) noexcept;
+    // Counts a node, returning whether the search should stop
+    bool CheckLimits(Thread &thread) noexcept;
+    void UpdatePV(Thread &thread, int ply, Move move) noexcept;
+    size_t ElapsedMs() const noexcept;
+};
+} // namespace Chess
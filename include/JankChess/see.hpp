@@ -0,0 +1,17 @@
+#pragma once
+
+#include <JankChess/board.hpp>
+#include <JankChess/move.hpp>
+#include <JankChess/types.hpp>
+#include <array>
+
+namespace Chess {
+// Value of each type of piece in an exchange, where the king is never captured
+constexpr std::array<int, PIECE_COUNT> SEE_VALUES = {100, 320, 330, 500, 900, 0};
+
+// Returns the static exchange evaluation of move, i.e. the material won by the side to move should
+// both sides keep recapturing on the destination with their least valuable attacker, for as long as
+// it is favourable to do so
+// Pins are ignored, and only the move itself may promote
+int SEE(const Board &board, Move move) noexcept;
+} // namespace Chess
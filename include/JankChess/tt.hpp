@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JankChess/move.hpp>
+#include <JankChess/types.hpp>
+#include <atomic>
+#include <optional>
+#include <vector>
+
+namespace Chess {
+// How a stored score relates to the true score of a position
+enum class Bound : uint8_t { None, Upper, Lower, Exact };
+
+struct TTEntry {
+    Move move;
+    int16_t score;
+    uint8_t depth;
+    Bound bound;
+};
+
+// Lockless table of search results, indexed by position hash, which may be shared by threads
+// Each position maps to a single entry, which is always replaced by newer results. An entry stores
+// its hash xor'ed with its data beside the data, such that an entry torn by racing writes fails
+// validation rather than returning the result of another position.
+class TranspositionTable {
+public:
+    // Creates a table of the largest power of two entries within mb megabytes
+    explicit TranspositionTable(size_t mb);
+
+    // Returns the entry of the position, if one is stored
+    std::optional<TTEntry> Probe(Hash hash) const noexcept;
+    // Stores the result of a search of the position, keeping the prior move if none is given
+    void Store(Hash hash, Move move, int score, int depth, Bound bound) noexcept;
+    // Removes all entries
+    void Clear() noexcept;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    std::vector<Slot> slots;
+    size_t mask;
+};
+} // namespace Chess
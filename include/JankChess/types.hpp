@@ -20,8 +20,10 @@ namespace Chess {
 
 // Maximum number of possible moves at any given position
 #define MAX_MOVES 256
-// Maximum number of moves from start pos
-#define MAX_PLY 256
+// Number of the most recent moves whose undo information is kept by a board, and so the most which
+// may be undone in a row
+// Must be a power of two, and exceed the depth of any search
+#define MAX_PLY 128
 
 // A bitmask of a chess board, where a one corresponds to the index of the
 // square
@@ -33,7 +35,7 @@ enum Color { WHITE, BLACK, COLOR_NONE };
 enum Piece { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, PIECE_NONE };
 enum Column { COL_A, COL_B, COL_C, COL_D, COL_E, COL_F, COL_G, COL_H, COL_NONE };
 enum Row { ROW_1, ROW_2, ROW_3, ROW_4, ROW_5, ROW_6, ROW_7, ROW_8, ROW_NONE };
-enum class Castling { None, King, Queen, Both };
+enum class Castling : uint8_t { None, King, Queen, Both };
 enum Direction {
     NORTH,
     EAST,
@@ -1,4 +1,4 @@
-#pragma Once
+#pragma once
 
 #include <JankChess/types.hpp>
 
@@ -7,8 +7,12 @@ namespace Chess {
 constexpr size_t HASH_COUNT = 1 + 4 * 2 + SQUARE_COUNT + COLOR_COUNT * PIECE_COUNT * SQUARE_COUNT;
 extern const std::array<Hash, HASH_COUNT> HASHES;
 
+// Toggles the key of black being the one to move
 Hash FlipTurn(Hash hash);
+// Toggles the key of the castling rights of a color
 Hash FlipCastle(Hash hash, Color color, Castling castling);
+// Toggles the key of the EP square, where SQUARE_NONE has no key
 Hash FlipEnpassant(Hash hash, Square sq);
+// Toggles the key of a piece of color being on square
 Hash FlipSquare(Hash hash, Color color, Piece piece_type, Square square);
 } // namespace Chess
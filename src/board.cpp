@@ -1,50 +1,32 @@
 #include "JankChess/bb.hpp"
 #include <JankChess/board.hpp>
+#include <JankChess/instrument.hpp>
 #include <JankChess/masks.hpp>
 #include <JankChess/zobrist.hpp>
+#include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <cstring>
 #include <sstream>
 
 namespace Chess {
-// CONSTRUCTOR
-
-Board::Board(std::string FEN) noexcept {
-    ClearBoard();
-    // import pieces
-    for (int y = HEIGHT - 1; y >= 0; y--) {
-        int remainingSquares = WIDTH;
-        while (remainingSquares > 0) {
-            if (isdigit(FEN[0]))
-                remainingSquares -= FEN[0] - 48;
-            else {
-                const Color color = islower(FEN[0]) ? BLACK : WHITE;
-                const Piece piece = ToPiece(FEN[0]);
-                assert(piece != PIECE_NONE);
-                const Square sq = static_cast<Square>(8 * y + WIDTH - remainingSquares--);
-                PlacePiece(color, piece, sq);
-            }
-            FEN.erase(0, 1);
-        }
-        FEN.erase(0, 1);
+const char *FENErrorName(FENError error) noexcept {
+    switch (error) {
+    case FENError::None: return "none";
+    case FENError::Pieces: return "pieces";
+    case FENError::Turn: return "turn";
+    case FENError::Castling: return "castling";
+    case FENError::EP: return "en passant";
+    case FENError::Clocks: return "clocks";
     }
+    return "unknown";
+}
 
-    this->turn = tolower(FEN[0]) == 'w' ? WHITE : BLACK;
-
-    FEN.erase(0, 2);
-    std::array<Castling, COLOR_COUNT> &castling = this->history[0].castling;
+// CONSTRUCTOR
 
-    while (FEN[0] != ' ' && !FEN.empty()) {
-        switch (FEN[0]) {
-        case 'K':
-        case 'k': castling[!!islower(FEN[0])] |= Castling::King; break;
-        case 'Q':
-        case 'q': castling[!!islower(FEN[0])] |= Castling::Queen; break;
-        case '-': break;
-        }
-        FEN.erase(0, 1);
-    }
-    FEN.erase(0, 1);
+Board::Board(std::string_view FEN) noexcept {
+    [[maybe_unused]] const FENResult result = ParseFEN(FEN);
+    assert(result.error == FENError::None);
 }
 
 Board::Board(const std::string &FEN, const std::string &moves) noexcept {
@@ -60,11 +42,113 @@ Board::Board(const std::string &FEN, const std::string &moves) noexcept {
 size_t Board::MoveCount() const noexcept { return this->move_count; }
 size_t Board::Ply() const noexcept { return this->ply; }
 Color Board::Turn() const noexcept { return this->turn; }
-Square Board::EP() const noexcept { return this->history[ply].ep; }
+Square Board::EP() const noexcept { return Stack(ply).ep; }
 Castling Board::GetCastling(Color color) const noexcept {
-    return this->history[ply].castling[color];
+    return Stack(ply).castling[color];
 }
 Hash Board::GetHash() const noexcept { return this->hash; }
+int Board::HalfmoveClock() const noexcept { return Stack(ply).halfmove; }
+bool Board::IsRepetition() const noexcept {
+    // Positions before the last capture or pawn move cannot recur, and those with the other side to
+    // move differ in hash
+    const size_t reversible = Stack(ply).halfmove;
+    // Plies since the history was attached, before which positions are found in it
+    const size_t since = this->ply - this->history_ply;
+    for (size_t i = 4; i <= reversible; i += 2) {
+        Hash hash;
+        if (i <= this->ply - this->oldest_ply)
+            hash = Stack(this->ply - i).hash;
+        else if (this->history && i > since && i - since <= this->history->size())
+            hash = (*this->history)[this->history->size() - (i - since)];
+        else
+            return false;
+        if (hash == this->hash) return true;
+    }
+    return false;
+}
+bool Board::IsFiftyMoveDraw() const noexcept { return Stack(ply).halfmove >= 100; }
+size_t Board::ExportFEN(char *buffer) const noexcept {
+    char *out = buffer;
+    for (int y = HEIGHT - 1; y >= 0; y--) {
+        int empty = 0;
+        for (int x = 0; x < WIDTH; x++) {
+            const Square sq = static_cast<Square>(8 * y + x);
+            if (SquarePiece(sq) == PIECE_NONE) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) *out++ = static_cast<char>('0' + empty);
+            empty  = 0;
+            *out++ = PIECE_CHARS[SquareColor(sq)][SquarePiece(sq)];
+        }
+        if (empty > 0) *out++ = static_cast<char>('0' + empty);
+        if (y > 0) *out++ = '/';
+    }
+
+    *out++ = ' ';
+    *out++ = Turn() == WHITE ? 'w' : 'b';
+    *out++ = ' ';
+
+    const char *castling_start = out;
+    for (const auto color : {WHITE, BLACK}) {
+        if ((bool)(GetCastling(color) & Castling::King)) *out++ = PIECE_CHARS[color][KING];
+        if ((bool)(GetCastling(color) & Castling::Queen)) *out++ = PIECE_CHARS[color][QUEEN];
+    }
+    if (out == castling_start) *out++ = '-';
+
+    *out++ = ' ';
+    if (EP() == SQUARE_NONE)
+        *out++ = '-';
+    else {
+        *out++ = SQUARE_NAMES[EP()][0];
+        *out++ = SQUARE_NAMES[EP()][1];
+    }
+
+    char *const end = buffer + FEN_MAX_LENGTH - 1;
+    *out++          = ' ';
+    out             = std::to_chars(out, end, HalfmoveClock()).ptr;
+    *out++          = ' ';
+    out             = std::to_chars(out, end, this->move_count / 2 + 1).ptr;
+    *out            = '\0';
+    return out - buffer;
+}
+std::string Board::ExportFEN() const {
+    char buffer[FEN_MAX_LENGTH];
+    return std::string(buffer, ExportFEN(buffer));
+}
+Hash Board::ComputeHashFromScratch() const noexcept {
+    Hash hash = 0;
+    for (const auto color : {WHITE, BLACK})
+        for (const auto piece : PIECES) {
+            BB pieces = Pieces(color, piece);
+            while (pieces)
+                hash = FlipSquare(hash, color, piece, lsb_pop(pieces));
+        }
+    for (const auto color : {WHITE, BLACK})
+        hash = FlipCastle(hash, color, GetCastling(color));
+    hash = FlipEnpassant(hash, EP());
+    if (Turn() == BLACK) hash = FlipTurn(hash);
+    return hash;
+}
+Score Board::GetPSQT() const noexcept { return this->psqt; }
+int Board::GetPhase() const noexcept { return this->phase; }
+Score Board::ComputePSQTFromScratch() const noexcept {
+    Score score;
+    for (const auto color : {WHITE, BLACK})
+        for (const auto piece : PIECES) {
+            BB pieces = Pieces(color, piece);
+            while (pieces)
+                score += PieceSquare(color, piece, lsb_pop(pieces));
+        }
+    return score;
+}
+int Board::ComputePhaseFromScratch() const noexcept {
+    int phase = 0;
+    for (const auto piece : PIECES)
+        phase += PHASE_WEIGHTS[piece] * popcount(Pieces(piece));
+    return phase;
+}
+const AccumulatorStack *Board::GetAccumulators() const noexcept { return this->accumulators; }
 BB Board::Pieces() const noexcept { return Pieces(WHITE) | Pieces(BLACK); };
 BB Board::Pieces(Piece piece) const noexcept { return this->pieces[piece]; }
 BB Board::Pieces(Color color) const noexcept { return this->colors[color]; }
@@ -77,45 +161,45 @@ Color Board::SquareColor(Square square) const noexcept {
 }
 
 bool Board::IsKingSafe(Color color) const noexcept {
-    const Square king = lsb(Pieces(color, KING));
+    return color == WHITE ? IsKingSafe<WHITE>() : IsKingSafe<BLACK>();
+}
+
+template <Color Us>
+bool Board::IsKingSafe() const noexcept {
+    JANKCHESS_ZONE("IsKingSafe");
+    JANKCHESS_COUNT(COUNTER_KING_SAFETY_CHECKS);
+    constexpr Color Them = !Us;
+    const Square king    = lsb(Pieces(Us, KING));
+#ifdef JANKCHESS_ATTACK_MAPS
+    return !(Attacks(Them) & king);
+#else
 
     const BB occ     = Pieces();
-    const BB pawns   = Pieces(!color, PAWN);
-    const BB knights = Pieces(!color, KNIGHT);
-    const BB kings   = Pieces(!color, KING);
-    const BB bishops = Pieces(!color, BISHOP) | Pieces(!color, QUEEN);
-    const BB rooks   = Pieces(!color, ROOK) | Pieces(!color, QUEEN);
+    const BB pawns   = Pieces(Them, PAWN);
+    const BB knights = Pieces(Them, KNIGHT);
+    const BB kings   = Pieces(Them, KING);
+    const BB bishops = Pieces(Them, BISHOP) | Pieces(Them, QUEEN);
+    const BB rooks   = Pieces(Them, ROOK) | Pieces(Them, QUEEN);
 
-    if (PAWN_ATTACKS[color][king] & pawns) return false;
+    if (PAWN_ATTACKS[Us][king] & pawns) return false;
     if (PSEUDO_ATTACKS[KNIGHT][king] & knights) return false;
     if (PSEUDO_ATTACKS[KING][king] & kings) return false;
 
-    if (const BB ray = DIR_RAYS[king][NORTH]; ray & rooks)
-        if (lsb(ray & rooks) == lsb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][EAST]; ray & rooks)
-        if (lsb(ray & rooks) == lsb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][SOUTH]; ray & rooks)
-        if (msb(ray & rooks) == msb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][WEST]; ray & rooks)
-        if (msb(ray & rooks) == msb(ray & occ)) return false;
-
-    if (const BB ray = DIR_RAYS[king][NORTH_EAST]; ray & bishops)
-        if (lsb(ray & bishops) == lsb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][NORTH_WEST]; ray & bishops)
-        if (lsb(ray & bishops) == lsb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][SOUTH_EAST]; ray & bishops)
-        if (msb(ray & bishops) == msb(ray & occ)) return false;
-    if (const BB ray = DIR_RAYS[king][SOUTH_WEST]; ray & bishops)
-        if (msb(ray & bishops) == msb(ray & occ)) return false;
+    if (RookAttacks(king, occ) & rooks) return false;
+    if (BishopAttacks(king, occ) & bishops) return false;
 
     return true;
+#endif
 }
+template bool Board::IsKingSafe<WHITE>() const noexcept;
+template bool Board::IsKingSafe<BLACK>() const noexcept;
 
-BB Board::GenerateAttacks(Color color) const noexcept {
-    const BB occ = Pieces();
-    BB pawns     = Pieces(color, PAWN);
-    BB knights   = Pieces(color, KNIGHT);
-    BB kings     = Pieces(color, KING);
+BB Board::GenerateAttacks(Color color) const noexcept { return GenerateAttacks(color, Pieces()); }
+
+BB Board::GenerateAttacks(Color color, BB occ) const noexcept {
+    BB pawns   = Pieces(color, PAWN);
+    BB knights = Pieces(color, KNIGHT);
+    BB kings   = Pieces(color, KING);
 
     BB attacks = 0;
 
@@ -126,42 +210,222 @@ BB Board::GenerateAttacks(Color color) const noexcept {
     while (kings)
         attacks |= PSEUDO_ATTACKS[KING][lsb_pop(kings)];
 
-    BB bishops    = Pieces(color, BISHOP) | Pieces(color, QUEEN);
-    BB rooks      = Pieces(color, ROOK) | Pieces(color, QUEEN);
-    BB sliders[2] = {bishops, rooks};
-    const std::array<std::array<BB, SQUARE_COUNT>, 2> &p_attacks = {
-        PSEUDO_ATTACKS[BISHOP], PSEUDO_ATTACKS[ROOK]
-    };
-    for (int i = 0; i < 2; i++) {
-        while (sliders[i]) {
-            const Square piece = lsb_pop(sliders[i]);
-            BB unblocked       = p_attacks[i][piece];
-            for (int offset = 1; offset < 8 && unblocked; offset++) {
-                BB p_ring   = RINGS[piece][offset] & unblocked;
-                BB blockers = p_ring & occ;
-
-                attacks |= p_ring;
-
-                while (blockers)
-                    unblocked &= ~SQ_RAYS[piece][lsb_pop(blockers)];
-            }
-        }
-    }
+    BB bishops = Pieces(color, BISHOP) | Pieces(color, QUEEN);
+    BB rooks   = Pieces(color, ROOK) | Pieces(color, QUEEN);
+
+    while (bishops)
+        attacks |= BishopAttacks(lsb_pop(bishops), occ);
+    while (rooks)
+        attacks |= RookAttacks(lsb_pop(rooks), occ);
+
     return attacks;
 }
 
+BB Board::AttackersTo(Square square) const noexcept { return AttackersTo(square, Pieces()); }
+
+BB Board::AttackersTo(Square square, BB occ) const noexcept {
+    const BB bishops = Pieces(BISHOP) | Pieces(QUEEN);
+    const BB rooks   = Pieces(ROOK) | Pieces(QUEEN);
+    return (PAWN_ATTACKS[BLACK][square] & Pieces(WHITE, PAWN)) |
+           (PAWN_ATTACKS[WHITE][square] & Pieces(BLACK, PAWN)) |
+           (PSEUDO_ATTACKS[KNIGHT][square] & Pieces(KNIGHT)) |
+           (PSEUDO_ATTACKS[KING][square] & Pieces(KING)) | (BishopAttacks(square, occ) & bishops) |
+           (RookAttacks(square, occ) & rooks);
+}
+
+BB Board::Attacks(Color color) const noexcept {
+#ifdef JANKCHESS_ATTACK_MAPS
+    return this->attacks[color];
+#else
+    return GenerateAttacks(color);
+#endif
+}
+
+int Board::AttackerCount(Color color, Square square) const noexcept {
+#ifdef JANKCHESS_ATTACK_MAPS
+    return this->attacker_counts[color][square];
+#else
+    return popcount(AttackersTo(square) & Pieces(color));
+#endif
+}
+
 // MODIFIERS
 
 void Board::ClearBoard() {
-    memset(this, 0, sizeof(Board));
-    for (int i = 0; i < MAX_PLY; i++) {
-        this->history[i].ep       = SQUARE_NONE;
-        this->history[i].captured = PIECE_NONE;
-    }
+    memset(this->pieces, 0, sizeof(this->pieces));
+    memset(this->colors, 0, sizeof(this->colors));
     for (const auto sq : SQUARES)
         this->square_pieces[sq] = PIECE_NONE;
+    this->turn         = WHITE;
+    this->hash         = 0;
+    this->psqt         = Score();
+    this->phase        = 0;
+    this->move_count   = 0;
+    this->ply          = 0;
+    this->oldest_ply   = 0;
+    this->history      = nullptr;
+    this->history_ply  = 0;
+    this->accumulators = nullptr;
+    // Every ply after the first is written by the move leading to it before being read, so only the
+    // first is cleared, rather than the whole stack
+    this->stack[0]          = PlyInfo();
+    this->stack[0].ep       = SQUARE_NONE;
+    this->stack[0].captured = PIECE_NONE;
+#ifdef JANKCHESS_ATTACK_MAPS
+    memset(this->square_attacks, 0, sizeof(this->square_attacks));
+    memset(this->attacker_counts, 0, sizeof(this->attacker_counts));
+    memset(this->attacks, 0, sizeof(this->attacks));
+#endif
+}
+
+// Parses an unsigned number at FEN[i], advancing i past it, or returns false if there is none
+static bool ParseNumber(std::string_view FEN, size_t &i, size_t &number) noexcept {
+    if (i >= FEN.size() || !isdigit(FEN[i])) return false;
+    number = 0;
+    for (; i < FEN.size() && isdigit(FEN[i]); i++)
+        number = std::min<size_t>(10 * number + (FEN[i] - '0'), UINT32_MAX);
+    return true;
 }
 
+FENResult Board::ParseFEN(std::string_view FEN) noexcept {
+    ClearBoard();
+    size_t i = 0;
+    // Fields are separated by a single space
+    const auto separator = [&]() {
+        if (i >= FEN.size() || FEN[i] != ' ') return false;
+        i++;
+        return true;
+    };
+
+    int x = 0, y = HEIGHT - 1;
+    for (; i < FEN.size() && FEN[i] != ' '; i++) {
+        const char c = FEN[i];
+        if (c == '/') {
+            if (x != WIDTH || y == 0) return {FENError::Pieces, i};
+            x = 0;
+            y--;
+        } else if (c >= '1' && c <= '8') {
+            x += c - '0';
+            if (x > WIDTH) return {FENError::Pieces, i};
+        } else {
+            const Piece piece = ToPiece(c);
+            if (piece == PIECE_NONE || x >= WIDTH) return {FENError::Pieces, i};
+            PlacePiece(isupper(c) ? WHITE : BLACK, piece, static_cast<Square>(8 * y + x++));
+        }
+    }
+    if (x != WIDTH || y != 0) return {FENError::Pieces, i};
+    // Neither move generation nor search can handle a side without a king, or with several
+    if (popcount(Pieces(WHITE, KING)) != 1 || popcount(Pieces(BLACK, KING)) != 1)
+        return {FENError::Pieces, i};
+
+    if (!separator() || i >= FEN.size() || (FEN[i] != 'w' && FEN[i] != 'b'))
+        return {FENError::Turn, i};
+    this->turn = FEN[i++] == 'w' ? WHITE : BLACK;
+
+    if (!separator() || i >= FEN.size() || FEN[i] == ' ') return {FENError::Castling, i};
+    std::array<Castling, COLOR_COUNT> &castling = Stack(0).castling;
+    // A right requires the king and the rook to be on their original squares
+    const auto castle = [&](Color color, Castling side, Square king, Square rook) {
+        if (!(Pieces(color, KING) & king) || !(Pieces(color, ROOK) & rook)) return false;
+        castling[color] |= side;
+        return true;
+    };
+    if (FEN[i] == '-')
+        i++;
+    else
+        for (; i < FEN.size() && FEN[i] != ' '; i++) {
+            bool valid;
+            switch (FEN[i]) {
+            case 'K': valid = castle(WHITE, Castling::King, E1, H1); break;
+            case 'Q': valid = castle(WHITE, Castling::Queen, E1, A1); break;
+            case 'k': valid = castle(BLACK, Castling::King, E8, H8); break;
+            case 'q': valid = castle(BLACK, Castling::Queen, E8, A8); break;
+            default: valid = false;
+            }
+            if (!valid) return {FENError::Castling, i};
+        }
+
+    if (!separator() || i >= FEN.size()) return {FENError::EP, i};
+    if (FEN[i] == '-')
+        i++;
+    else {
+        // The square is behind a pawn which has just moved, so on the third row from its side
+        const char row = this->turn == WHITE ? '6' : '3';
+        if (i + 1 >= FEN.size() || FEN[i] < 'a' || FEN[i] > 'h' || FEN[i + 1] != row)
+            return {FENError::EP, i};
+        Stack(0).ep = ToSquare(ToCol(FEN[i]), ToRow(FEN[i + 1]));
+        i += 2;
+    }
+
+    // The clocks are optional, and default to those of a new game, such that the operations of an
+    // EPD may follow the en passant square instead
+    size_t halfmove = 0, fullmove = 1;
+    if (i + 1 < FEN.size() && FEN[i] == ' ' && isdigit(FEN[i + 1])) {
+        i++;
+        ParseNumber(FEN, i, halfmove);
+        if (!separator() || !ParseNumber(FEN, i, fullmove)) return {FENError::Clocks, i};
+    }
+    Stack(0).halfmove = static_cast<uint16_t>(std::min<size_t>(halfmove, UINT16_MAX));
+    this->move_count  = 2 * (std::max<size_t>(fullmove, 1) - 1) + (this->turn == BLACK);
+
+    this->hash    = ComputeHashFromScratch();
+    Stack(0).hash = this->hash;
+    return {FENError::None, i};
+}
+
+#ifdef JANKCHESS_ATTACK_MAPS
+// Returns the squares attacked by a piece of color on square
+static BB PieceAttacks(Color color, Piece piece, Square square, BB occ) noexcept {
+    switch (piece) {
+    case PAWN: return PAWN_ATTACKS[color][square];
+    case BISHOP: return BishopAttacks(square, occ);
+    case ROOK: return RookAttacks(square, occ);
+    case QUEEN: return BishopAttacks(square, occ) | RookAttacks(square, occ);
+    default: return PSEUDO_ATTACKS[piece][square];
+    }
+}
+
+template <bool Add>
+void Board::CountAttacks(Color color, BB bb) noexcept {
+    while (bb) {
+        const Square sq = lsb_pop(bb);
+        if constexpr (Add) {
+            if (this->attacker_counts[color][sq]++ == 0) this->attacks[color] ^= sq;
+        } else {
+            if (--this->attacker_counts[color][sq] == 0) this->attacks[color] ^= sq;
+        }
+    }
+}
+
+void Board::UpdateAttacks(Color color, Piece piece, Square square) noexcept {
+    const BB occ       = Pieces();
+    const bool present = square & occ;
+    if (!present) {
+        CountAttacks<false>(color, this->square_attacks[square]);
+        this->square_attacks[square] = 0;
+    }
+
+    // Only sliders seeing the square have been blocked, or unblocked, by it
+    BB sliders = (BishopAttacks(square, occ) & (Pieces(BISHOP) | Pieces(QUEEN))) |
+                 (RookAttacks(square, occ) & (Pieces(ROOK) | Pieces(QUEEN)));
+    while (sliders) {
+        const Square slider       = lsb_pop(sliders);
+        const Color slider_color  = SquareColor(slider);
+        const BB prior            = this->square_attacks[slider];
+        const BB current          = PieceAttacks(slider_color, SquarePiece(slider), slider, occ);
+        this->square_attacks[slider] = current;
+        CountAttacks<false>(slider_color, prior & ~current);
+        CountAttacks<true>(slider_color, current & ~prior);
+    }
+
+    if (present) {
+        this->square_attacks[square] = PieceAttacks(color, piece, square, occ);
+        CountAttacks<true>(color, this->square_attacks[square]);
+    }
+}
+#endif
+
+template <bool Accumulate>
 void Board::FlipPiece(Color color, Piece piece, Square square) noexcept {
     assert(color != COLOR_NONE);
     assert(piece != PIECE_NONE);
@@ -169,28 +433,83 @@ void Board::FlipPiece(Color color, Piece piece, Square square) noexcept {
     this->colors[color] ^= square;
     this->pieces[piece] ^= square;
     this->hash = FlipSquare(this->hash, color, piece, square);
+#ifdef JANKCHESS_ATTACK_MAPS
+    UpdateAttacks(color, piece, square);
+#endif
+    if constexpr (Accumulate)
+        if (this->accumulators) [[unlikely]] {
+            if (square & this->colors[color])
+                this->accumulators->Add(ply, color, piece, square);
+            else
+                this->accumulators->Remove(ply, color, piece, square);
+        }
 }
+template <bool Accumulate>
 void Board::PlacePiece(Color color, Piece piece, Square square) noexcept {
-    FlipPiece(color, piece, square);
+    FlipPiece<Accumulate>(color, piece, square);
     this->square_pieces[square] = piece;
+    this->psqt += PieceSquare(color, piece, square);
+    this->phase += PHASE_WEIGHTS[piece];
 }
+template void Board::PlacePiece<true>(Color color, Piece piece, Square square) noexcept;
+template void Board::PlacePiece<false>(Color color, Piece piece, Square square) noexcept;
+template <bool Accumulate>
 void Board::RemovePiece(Color color, Piece piece, Square square) noexcept {
-    FlipPiece(color, piece, square);
+    FlipPiece<Accumulate>(color, piece, square);
     this->square_pieces[square] = PIECE_NONE;
+    this->psqt -= PieceSquare(color, piece, square);
+    this->phase -= PHASE_WEIGHTS[piece];
+}
+template void Board::RemovePiece<true>(Color color, Piece piece, Square square) noexcept;
+template void Board::RemovePiece<false>(Color color, Piece piece, Square square) noexcept;
+void Board::AttachAccumulators(AccumulatorStack *accumulators) noexcept {
+    this->accumulators = accumulators;
+    if (accumulators) accumulators->Refresh(*this, ply);
 }
+void Board::AttachHistory(const GameHistory *history) noexcept {
+    this->history     = history;
+    this->history_ply = this->ply;
+}
+void Board::ApplyMove(Move move) noexcept {
+    if (Turn() == WHITE)
+        ApplyMove<WHITE>(move);
+    else
+        ApplyMove<BLACK>(move);
+}
+
+template <Color Us>
 void Board::ApplyMove(Move move) noexcept {
+    JANKCHESS_ZONE("ApplyMove");
+    JANKCHESS_COUNT(COUNTER_MOVES_APPLIED);
+    // Dispatched once per move, rather than checked upon every piece moved
+    if (this->accumulators) [[unlikely]]
+        DoMove<Us, true>(move);
+    else
+        DoMove<Us, false>(move);
+}
+template void Board::ApplyMove<WHITE>(Move move) noexcept;
+template void Board::ApplyMove<BLACK>(Move move) noexcept;
+
+template <Color Us, bool Accumulate>
+void Board::DoMove(Move move) noexcept {
+    assert(Turn() == Us);
     this->ply++;
-    this->history[ply].castling = this->history[ply - 1].castling;
-    const Color us              = Turn();
-    const Color nus             = !us;
-    const Square ori            = move.Origin();
-    const Square dst            = move.Destination();
-    Piece piece                 = SquarePiece(ori);
-    Piece target                = PIECE_NONE;
-    Square target_square        = dst;
-    Square ep                   = SQUARE_NONE;
-
-    RemovePiece(us, piece, ori);
+    // The undo information of the ply MAX_PLY before is overwritten
+    if (ply >= MAX_PLY) this->oldest_ply = std::max(this->oldest_ply, ply - MAX_PLY + 1);
+    Stack(ply).castling  = Stack(ply - 1).castling;
+    constexpr Color us   = Us;
+    constexpr Color nus  = !Us;
+    const Square ori     = move.Origin();
+    const Square dst     = move.Destination();
+    Piece piece          = SquarePiece(ori);
+    Piece target         = PIECE_NONE;
+    Square target_square = dst;
+    Square ep            = SQUARE_NONE;
+    const bool pawn_move = piece == PAWN;
+
+    if constexpr (Accumulate) this->accumulators->Push(ply);
+
+    RemovePiece<Accumulate>(us, piece, ori);
 
     switch (move.GetType()) {
     case Move::KingCastle:
@@ -200,8 +519,8 @@ void Board::ApplyMove(Move move) noexcept {
         const bool king_side        = dst > ori;
         const Square rook_ori       = ROOK_ORI[king_side][us];
         const Square rook_dst       = ROOK_DST[king_side][us];
-        RemovePiece(us, ROOK, rook_ori);
-        PlacePiece(us, ROOK, rook_dst);
+        RemovePiece<Accumulate>(us, ROOK, rook_ori);
+        PlacePiece<Accumulate>(us, ROOK, rook_dst);
         break;
     }
     case Move::NPromotion: piece = KNIGHT; break;
@@ -213,56 +532,87 @@ void Board::ApplyMove(Move move) noexcept {
     case Move::RPromotionCapture: piece = ROOK; goto CAPTURE;
     case Move::QPromotionCapture: piece = QUEEN; goto CAPTURE;
     case Move::EPCapture:
-        target_square = static_cast<Square>(this->history[ply - 1].ep + (us == WHITE ? -8 : 8));
+        target_square = static_cast<Square>(Stack(ply - 1).ep + (Us == WHITE ? -8 : 8));
     case Move::Capture: {
     CAPTURE:
         target = SquarePiece(target_square);
-        RemovePiece(nus, target, target_square);
+        RemovePiece<Accumulate>(nus, target, target_square);
         if (target_square == CORNER_A[nus])
-            this->history[ply].castling[nus] &= Castling::King;
+            Stack(ply).castling[nus] &= Castling::King;
         else if (target_square == CORNER_H[nus])
-            this->history[ply].castling[nus] &= Castling::Queen;
+            Stack(ply).castling[nus] &= Castling::Queen;
         break;
     }
-    case Move::DoublePawnPush: ep = static_cast<Square>((us == WHITE) ? ori + 8 : ori - 8); break;
+    case Move::DoublePawnPush: ep = static_cast<Square>(Us == WHITE ? ori + 8 : ori - 8); break;
     default: break;
     }
 
-    PlacePiece(us, piece, dst);
+    PlacePiece<Accumulate>(us, piece, dst);
 
     if (piece == KING) [[unlikely]]
-        this->history[ply].castling[us] = Castling::None;
+        Stack(ply).castling[us] = Castling::None;
     else if (piece == ROOK) [[unlikely]] {
         if (ori == CORNER_A[us])
-            this->history[ply].castling[us] &= Castling::King;
+            Stack(ply).castling[us] &= Castling::King;
         else if (ori == CORNER_H[us])
-            this->history[ply].castling[us] &= Castling::Queen;
+            Stack(ply).castling[us] &= Castling::Queen;
     }
 
-    if (auto p_ep = this->history[ply - 1].ep; p_ep != ep) {
+    if (auto p_ep = Stack(ply - 1).ep; p_ep != ep) {
         this->hash = FlipEnpassant(this->hash, ep);
         this->hash = FlipEnpassant(this->hash, p_ep);
     }
+    for (const auto color : {WHITE, BLACK}) {
+        const Castling p_castling = Stack(ply - 1).castling[color];
+        const Castling castling   = Stack(ply).castling[color];
+        if (p_castling != castling) [[unlikely]] {
+            this->hash = FlipCastle(this->hash, color, p_castling);
+            this->hash = FlipCastle(this->hash, color, castling);
+        }
+    }
 
     this->move_count++;
-    this->history[ply].ep       = ep;
-    this->history[ply].captured = target;
-    this->turn                  = !this->Turn();
-    this->hash                  = FlipTurn(this->hash);
+    Stack(ply).ep       = ep;
+    Stack(ply).captured = target;
+    this->turn          = nus;
+    this->hash          = FlipTurn(this->hash);
+
+    // The clock is reset by any capture or pawn move
+    Stack(ply).halfmove = pawn_move || target != PIECE_NONE ? 0 : Stack(ply - 1).halfmove + 1;
+    Stack(ply).hash     = this->hash;
+    assert(this->hash == ComputeHashFromScratch());
+    assert(this->psqt == ComputePSQTFromScratch());
+    assert(this->phase == ComputePhaseFromScratch());
+#ifdef JANKCHESS_ATTACK_MAPS
+    assert(this->attacks[WHITE] == GenerateAttacks(WHITE));
+    assert(this->attacks[BLACK] == GenerateAttacks(BLACK));
+#endif
+}
+
+void Board::UndoMove(Move move) noexcept {
+    if (Turn() == BLACK)
+        UndoMove<WHITE>(move);
+    else
+        UndoMove<BLACK>(move);
 }
+
+template <Color Us>
 void Board::UndoMove(Move move) noexcept {
-    this->turn           = !this->Turn();
-    this->hash           = FlipTurn(this->hash);
-    const Color us       = Turn();
-    const Color nus      = !us;
+    JANKCHESS_ZONE("UndoMove");
+    assert(Turn() == !Us);
+    constexpr Color us   = Us;
+    constexpr Color nus  = !Us;
+    this->turn           = us;
     const Square ori     = move.Origin();
     const Square dst     = move.Destination();
     Piece piece          = SquarePiece(dst);
-    Piece target         = this->history[ply].captured;
+    Piece target         = Stack(ply).captured;
     Square target_square = dst;
+    // Only the last MAX_PLY - 1 moves may be undone
+    assert(ply > this->oldest_ply);
     this->ply--;
 
-    RemovePiece(us, piece, dst);
+    RemovePiece<false>(us, piece, dst);
 
     switch (move.GetType()) {
     case Move::KingCastle:
@@ -272,8 +622,8 @@ void Board::UndoMove(Move move) noexcept {
         const bool king_side        = dst > ori;
         const Square rook_ori       = ROOK_ORI[king_side][us];
         const Square rook_dst       = ROOK_DST[king_side][us];
-        RemovePiece(us, ROOK, rook_dst);
-        PlacePiece(us, ROOK, rook_ori);
+        RemovePiece<false>(us, ROOK, rook_dst);
+        PlacePiece<false>(us, ROOK, rook_ori);
         break;
     }
     case Move::NPromotion:
@@ -284,19 +634,25 @@ void Board::UndoMove(Move move) noexcept {
     case Move::BPromotionCapture:
     case Move::RPromotionCapture:
     case Move::QPromotionCapture: piece = PAWN; goto CAPTURE;
-    case Move::EPCapture: target_square = static_cast<Square>(EP() + (us == WHITE ? -8 : 8));
+    case Move::EPCapture: target_square = static_cast<Square>(EP() + (Us == WHITE ? -8 : 8));
     case Move::Capture:
     CAPTURE:
-        PlacePiece(nus, target, target_square);
+        PlacePiece<false>(nus, target, target_square);
         break;
     default: break;
     }
 
-    PlacePiece(us, piece, ori);
+    PlacePiece<false>(us, piece, ori);
 
-    if (this->history[ply].ep != this->history[ply + 1].ep) {
-        this->hash = FlipEnpassant(this->hash, this->history[ply].ep);
-        this->hash = FlipEnpassant(this->hash, this->history[ply + 1].ep);
-    }
+    this->hash = Stack(ply).hash;
+    assert(this->hash == ComputeHashFromScratch());
+    assert(this->psqt == ComputePSQTFromScratch());
+    assert(this->phase == ComputePhaseFromScratch());
+#ifdef JANKCHESS_ATTACK_MAPS
+    assert(this->attacks[WHITE] == GenerateAttacks(WHITE));
+    assert(this->attacks[BLACK] == GenerateAttacks(BLACK));
+#endif
 }
+template void Board::UndoMove<WHITE>(Move move) noexcept;
+template void Board::UndoMove<BLACK>(Move move) noexcept;
 } // namespace Chess
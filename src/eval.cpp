@@ -0,0 +1,17 @@
+#include <JankChess/eval.hpp>
+#include <JankChess/psqt.hpp>
+#include <JankChess/search.hpp>
+#include <algorithm>
+
+namespace Chess {
+int Evaluate(const Board &board) noexcept {
+    // A network is unbounded, so its output is kept clear of mate scores
+    if (const auto accumulators = board.GetAccumulators())
+        return std::clamp(
+            accumulators->Evaluate(board.Ply(), board.Turn()), -SCORE_MATE + MAX_DEPTH + 1,
+            SCORE_MATE - MAX_DEPTH - 1
+        );
+    const int score = Taper(board.GetPSQT(), board.GetPhase());
+    return board.Turn() == WHITE ? score : -score;
+}
+} // namespace Chess
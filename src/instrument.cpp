@@ -0,0 +1,96 @@
+#include <JankChess/instrument.hpp>
+#include <mutex>
+
+namespace Chess {
+#ifdef JANKCHESS_STATS
+static std::mutex counters_mutex;
+// Counts of the threads which have exited
+static Counters exited_counters = {};
+
+ThreadCounters::~ThreadCounters() {
+    std::lock_guard lock(counters_mutex);
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+        exited_counters[i] += counts[i];
+}
+
+Counters CounterTotals() noexcept {
+    std::lock_guard lock(counters_mutex);
+    Counters totals = exited_counters;
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+        totals[i] += thread_counters.counts[i];
+    return totals;
+}
+#else
+Counters CounterTotals() noexcept { return {}; }
+#endif
+
+void PrintCounters(FILE *file, const Counters &counters) {
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+        if (counters[i] > 0)
+            fprintf(file, "%s %zu\n", COUNTER_NAMES[i], static_cast<size_t>(counters[i]));
+}
+
+#ifdef JANKCHESS_TRACE
+// A trace event along with the thread which recorded it
+struct ThreadEvent {
+    TraceEvent event;
+    size_t thread;
+};
+
+static std::mutex trace_mutex;
+// Zones of the threads which have exited
+static std::vector<ThreadEvent> exited_events;
+static size_t exited_dropped = 0;
+// Threads are numbered in the order in which they exit, as the trace only needs to tell them apart
+static size_t exited_threads = 0;
+
+ThreadTrace::~ThreadTrace() {
+    std::lock_guard lock(trace_mutex);
+    const size_t thread = ++exited_threads;
+    for (const auto &event : events)
+        exited_events.push_back({event, thread});
+    exited_dropped += dropped;
+}
+
+int64_t TraceNow() noexcept {
+    static const auto epoch                = std::chrono::steady_clock::now();
+    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - epoch;
+    return elapsed.count();
+}
+
+// Writes a complete event, with timestamps in microseconds as is expected by viewers
+static void WriteEvent(FILE *file, const TraceEvent &event, size_t thread, bool first) {
+    fprintf(
+        file,
+        "%s    {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %zu, \"ts\": %.3f, "
+        "\"dur\": %.3f}",
+        first ? "" : ",\n", event.name, thread, event.start / 1000.0, event.duration / 1000.0
+    );
+}
+
+bool WriteTrace(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    std::lock_guard lock(trace_mutex);
+    fprintf(file, "{\n  \"traceEvents\": [\n");
+    bool first = true;
+    for (const auto &[event, thread] : exited_events) {
+        WriteEvent(file, event, thread, first);
+        first = false;
+    }
+    // The calling thread has not exited, so is numbered after every thread which has
+    for (const auto &event : thread_trace.events) {
+        WriteEvent(file, event, exited_threads + 1, first);
+        first = false;
+    }
+    fprintf(
+        file, "\n  ],\n  \"otherData\": {\"dropped\": %zu}\n}\n",
+        exited_dropped + thread_trace.dropped
+    );
+    return fclose(file) == 0;
+}
+#else
+bool WriteTrace(const char *) { return false; }
+#endif
+} // namespace Chess
@@ -1,6 +1,12 @@
 #include "JankChess/bb.hpp"
 #include <JankChess/masks.hpp>
 
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
 namespace Chess {
 constexpr bool Valid(Column col, Row row) {
     return col >= COL_A && col <= COL_H && row >= ROW_1 && row <= ROW_8;
@@ -98,6 +104,15 @@ constexpr std::array<std::array<BB, SQUARE_COUNT>, SQUARE_COUNT> XRAYS = [] {
     return rays;
 }();
 
+// Squares strictly between two squares on a shared line, empty if they share none
+constexpr std::array<std::array<BB, SQUARE_COUNT>, SQUARE_COUNT> BETWEEN = [] {
+    auto between = decltype(BETWEEN){0};
+    for (const auto ori : SQUARES)
+        for (const auto dst : SQUARES)
+            between[ori][dst] = SQ_RAYS[ori][dst] & SQ_RAYS[dst][ori];
+    return between;
+}();
+
 constexpr std::array<std::array<BB, SQUARE_COUNT + 1>, COLOR_COUNT> PAWN_ATTACKS = [] {
     auto attacks = decltype(PAWN_ATTACKS){0};
     for (int c = 0; c < 2; c++) {
@@ -144,4 +159,176 @@ constexpr std::array<std::array<BB, SQUARE_COUNT>, PIECE_COUNT> PSEUDO_ATTACKS =
 
     return attacks;
 }();
+
+// Attacks of a slider on sq, given occupancy, computed by walking each ray up to the first blocker
+constexpr BB SlidingAttacks(Piece piece, Square sq, BB occ) {
+    constexpr Direction DIRS[2][4] = {
+        {NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST}, {NORTH, EAST, SOUTH, WEST}
+    };
+
+    BB attacks = 0;
+    for (const auto dir : DIRS[piece == ROOK]) {
+        BB ray           = DIR_RAYS[sq][dir];
+        const BB blocked = ray & occ;
+        if (blocked) {
+            // The nearest blocker is the lowest square on rays ascending from sq, else the highest
+            const bool ascending = ray > ToBB(sq);
+            ray &= ~DIR_RAYS[ascending ? lsb(blocked) : msb(blocked)][dir];
+        }
+        attacks |= ray;
+    }
+    return attacks;
+}
+
+// clang-format off
+constexpr BB BISHOP_MAGIC_NUMBERS[SQUARE_COUNT] = {
+    0x10102002004a1420, 0x8020040400584008, 0x10510800811201c8, 0x5204042080000088,
+    0x2204106880000002, 0x1401042004000000, 0x400880410042004,  0x28208200a02020,
+    0x1500241990010e00, 0x8001200182020a40, 0x40004101030b0000, 0x8002041042000100,
+    0x4010011041020038, 0x10421044000,      0x1500210808020a00, 0x8000088400880520,
+    0x405004010040100,  0x1005823210040108, 0x2708008102040011, 0x4048200404009100,
+    0x18104101400024,   0x3000601190101,    0x8004803108491000, 0x8014241200820800,
+    0x6e080100c3040,    0x501044a11041800,  0x9020300008004045, 0x894080000220040,
+    0x1001010083104000, 0x5004030040900080, 0x400422c012400,    0x2128698404812,
+    0x1010108404900440, 0x928021182084100,  0x2006080409020024, 0x1010202020180080,
+    0xa010008200202200, 0x2098015100019004, 0x2041440810811,    0x802a02020000b098,
+    0x9015090004060,    0x4000821082081001, 0x100210040420800,  0x800004010488a00,
+    0x2000081104004040, 0x4c8e029015000082, 0x420340322224842,  0x1298260043400210,
+    0x822802400008,     0x8a0101600000,     0x3040003412080021, 0x3040290220884800,
+    0x4a1500401041004a, 0x8010200282020781, 0x20203142209091,   0x70300600902110,
+    0x40808800b62048,   0x810400c44420,     0x80400440c0441,    0x8340080020840411,
+    0x104208200,        0x800810d00080,     0x400530411080200,  0x4040702400932244,
+};
+
+constexpr BB ROOK_MAGIC_NUMBERS[SQUARE_COUNT] = {
+    0x1080004008801020, 0x840092002c03000,  0x1900200010400900, 0x880100008000480,
+    0x4200100420080200, 0x8100020100080400, 0x200040110886200,  0x200008040220411,
+    0x404800084400220,  0x401000402000,     0x86001081220440,   0x408800800100280,
+    0xa001201040820,    0x8848800200840080, 0x4001000100040200, 0x442000102105084,
+    0x9080010020804100, 0x40404000201009,   0x808010002009,     0x2200090021d00100,
+    0x8008008040080,    0x4004002010040,    0x11040008015042,   0xa0001768104,
+    0x800080204009,     0x2010004140002001, 0x9800200280100080, 0x1000100080080080,
+    0x442000a00049020,  0x2100040080020080, 0x800120400900148,  0x10040a00128541,
+    0x2800804000800030, 0x1010002000400041, 0x4000200011004100, 0x610008410800800,
+    0x400802402800800,  0xc100020080800400, 0x2000802000401,    0x182085882000401,
+    0x220204000808000,  0x2860100040024022, 0x1002004110040,    0x99101042000a0020,
+    0x4080004008080,    0x10040002008080,   0x2012004881020004, 0x8300842444820011,
+    0x88403882010200,   0x820400080210100,  0x110910040a00300,  0x801100280080480,
+    0x242009008200600,  0x1002000489500200, 0x40800200010080,   0x91800041000080,
+    0x209300488001,     0x4c1002414824001,  0x20020000b001041,  0x7000100004200901,
+    0x8002002004100802, 0x30010002084c0007, 0x888221800813004,  0x4000002840840112,
+};
+// clang-format on
+
+// Builds the magic entries of a slider, placing their attack sets consecutively from offset
+constexpr std::array<Magic, SQUARE_COUNT>
+BuildMagics(Piece piece, const BB (&numbers)[SQUARE_COUNT], size_t offset) {
+    std::array<Magic, SQUARE_COUNT> magics{};
+    for (const auto sq : SQUARES) {
+        // Edge squares never block a ray, unless the slider itself moves along that edge
+        const BB edges = (EDGE_HORIZONTAL & ~(RANK_1 << (8 * ToRow(sq)))) |
+                         (EDGE_VERTICAL & ~(FILE_A << ToCol(sq)));
+        const BB mask = PSEUDO_ATTACKS[piece][sq] & ~edges;
+
+        magics[sq] = {mask, numbers[sq], offset, 64 - popcount(mask)};
+        offset += static_cast<size_t>(1) << popcount(mask);
+    }
+    return magics;
+}
+
+constexpr std::array<Magic, SQUARE_COUNT> BISHOP_MAGICS =
+    BuildMagics(BISHOP, BISHOP_MAGIC_NUMBERS, 0);
+constexpr std::array<Magic, SQUARE_COUNT> ROOK_MAGICS =
+    BuildMagics(ROOK, ROOK_MAGIC_NUMBERS, BISHOP_ATTACK_COUNT);
+
+#ifndef JANKCHESS_NATIVE
+SliderBackend SLIDER_BACKEND = SliderBackend::Magic;
+#endif
+
+// Too large to be evaluated at compile time, so it is filled in during static initialization
+std::array<BB, SLIDER_ATTACK_COUNT> SLIDER_ATTACKS;
+
+void BuildSliderAttacks() {
+    for (const auto piece : {BISHOP, ROOK}) {
+        const auto &magics = (piece == BISHOP) ? BISHOP_MAGICS : ROOK_MAGICS;
+        for (const auto sq : SQUARES) {
+            const Magic &magic = magics[sq];
+            // Enumerate every subset of the mask by the Carry-Rippler trick
+            BB occ = 0;
+            do {
+                SLIDER_ATTACKS[magic.Index(occ)] = SlidingAttacks(piece, sq, occ);
+                occ                              = (occ - magic.mask) & magic.mask;
+            } while (occ);
+        }
+    }
+}
+
+bool SliderBackendSupported(SliderBackend backend) {
+#ifdef JANKCHESS_NATIVE
+    return backend == SLIDER_BACKEND;
+#else
+    switch (backend) {
+    case SliderBackend::Magic: return true;
+    case SliderBackend::Pext:
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("bmi2");
+#else
+        return false;
+#endif
+    }
+    return false;
+#endif
+}
+
+bool SetSliderBackend(SliderBackend backend) {
+    if (!SliderBackendSupported(backend)) return false;
+#ifndef JANKCHESS_NATIVE
+    SLIDER_BACKEND = backend;
+#endif
+    BuildSliderAttacks();
+    return true;
+}
+
+const char *SliderBackendName(SliderBackend backend) {
+    switch (backend) {
+    case SliderBackend::Magic: return "magic";
+    case SliderBackend::Pext: return "pext";
+    }
+    return "unknown";
+}
+
+#ifndef JANKCHESS_NATIVE
+// Whether PEXT is implemented in hardware, rather than microcode, on this CPU
+static bool FastPext() {
+    if (!SliderBackendSupported(SliderBackend::Pext)) return false;
+#if defined(__x86_64__)
+    // The vendor is spelled out by ebx, edx, then ecx
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    char vendor[13] = {};
+    memcpy(vendor, &ebx, 4);
+    memcpy(vendor + 4, &edx, 4);
+    memcpy(vendor + 8, &ecx, 4);
+    // Zen 1 and 2 (family 0x17), as well as Hygon Dhyana (family 0x18) which is derived from Zen 1,
+    // run PEXT in microcode, with a latency dependent on the mask
+    // Zen 3 onwards (family 0x19 and beyond) run it in a single cycle
+    if (strcmp(vendor, "AuthenticAMD") == 0 || strcmp(vendor, "HygonGenuine") == 0) {
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+        const unsigned int family = ((eax >> 8) & 0xf) + ((eax >> 20) & 0xff);
+        return family >= 0x19;
+    }
+#endif
+    return true;
+}
+#endif
+
+[[maybe_unused]] static const bool SLIDER_ATTACKS_INITIALIZED = [] {
+#ifdef JANKCHESS_NATIVE
+    BuildSliderAttacks();
+#else
+    SetSliderBackend(FastPext() ? SliderBackend::Pext : SliderBackend::Magic);
+#endif
+    return true;
+}();
 } // namespace Chess
@@ -1,4 +1,5 @@
 #include <JankChess/move.hpp>
+#include <cstdlib>
 
 namespace Chess {
 Move::Move(Square origin, Square destination, Type type)
@@ -20,7 +21,7 @@ Move::Move(BB occ, BB kings, BB pawns, const std::string &move) {
             *this = Move(ori, dst, QueenCastle);
         else if ((pawns & ori) && (ToCol(ori) != ToCol(dst)) && !capture)
             *this = Move(ori, dst, EPCapture);
-        else if ((pawns & ori) && (dst - ori > 8))
+        else if ((pawns & ori) && std::abs(dst - ori) == 16)
             *this = Move(ori, dst, DoublePawnPush);
         else
             *this = Move(ori, dst, Quiet);
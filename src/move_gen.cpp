@@ -1,174 +1,185 @@
 #include <JankChess/bb.hpp>
+#include <JankChess/instrument.hpp>
 #include <JankChess/masks.hpp>
 #include <JankChess/move_gen.hpp>
+#include <JankChess/move_visit.hpp>
 #include <JankChess/types.hpp>
-#include <optional>
 
 namespace Chess {
-void BuildPawnMoves(MoveList &moves, BB targets, int delta, Move::Type type) noexcept {
-    while (targets) {
-        const Square dst = lsb_pop(targets);
-        const Square ori = static_cast<Square>(dst - delta);
-        moves << Move(ori, dst, type);
-    }
-}
-
-void BuildPromotionMoves(MoveList &moves, BB targets, int delta, bool capture) noexcept {
-    BuildPawnMoves(moves, targets, delta, (Move::Type)(Move::NPromotion + 4 * capture));
-    BuildPawnMoves(moves, targets, delta, (Move::Type)(Move::BPromotion + 4 * capture));
-    BuildPawnMoves(moves, targets, delta, (Move::Type)(Move::RPromotion + 4 * capture));
-    BuildPawnMoves(moves, targets, delta, (Move::Type)(Move::QPromotion + 4 * capture));
+// Pseudo-legality checks and legal move counts are built from the same blocks as the visitors
+using namespace detail;
+
+// The counter of moves generated of the type of move
+static inline Counter MoveCounter(Move move) noexcept {
+    if (move.IsPromotion()) return COUNTER_MOVES_PROMOTION;
+    if (move.IsEnPassant()) return COUNTER_MOVES_EP;
+    if (move.IsCapture()) return COUNTER_MOVES_CAPTURE;
+    if (move.IsCastle()) return COUNTER_MOVES_CASTLE;
+    return COUNTER_MOVES_QUIET;
 }
 
-void GeneratePawnQuiet(MoveList &moves, Color turn, BB pawns, BB empty) noexcept {
-    static const int DELTA[COLOR_COUNT]        = {8, -8};
-    static const BB ADVANCED_ONCE[COLOR_COUNT] = {RANK_3, RANK_6};
-    static const BB PROMOTED_RANK              = RANK_8 | RANK_1;
-
-    BB advanced       = shift_up(pawns, turn) & empty;
-    BB advanced_twice = shift_up(advanced & ADVANCED_ONCE[turn], turn) & empty;
-    BB promoted       = advanced & PROMOTED_RANK;
-    advanced          = advanced ^ promoted;
+// Visitor collecting moves into a list
+// Moves are counted here rather than as they are visited, as pseudo-legality checks visit moves
+// which are never generated
+struct MoveCollector {
+    MoveList &moves;
+    bool operator()(Move move) noexcept {
+        moves << move;
+        JANKCHESS_COUNT(MoveCounter(move));
+        return true;
+    }
+};
 
-    BuildPawnMoves(moves, advanced, DELTA[turn], Move::Quiet);
-    BuildPawnMoves(moves, advanced_twice, 2 * DELTA[turn], Move::DoublePawnPush);
-    BuildPromotionMoves(moves, promoted, DELTA[turn], false);
+void GenerateMovesQuiet(MoveList &moves, const Board &board, Color color) noexcept {
+    VisitMovesQuiet(board, color, MoveCollector{moves});
 }
 
-void GeneratePawnTactical(MoveList &moves, Color turn, BB pawns, BB nus, Square ep) noexcept {
-    static const int LEFT_DELTA[COLOR_COUNT]  = {7, -9};
-    static const int RIGHT_DELTA[COLOR_COUNT] = {9, -7};
-    static const BB PROMOTED_RANK             = RANK_8 | RANK_1;
-
-    // Left and right from the perspective of white
-    BB left_capture    = nus & (turn == WHITE ? pawns << 7 : pawns >> 9) & ~FILE_H;
-    BB right_capture   = nus & (turn == WHITE ? pawns << 9 : pawns >> 7) & ~FILE_A;
-    BB left_promotion  = left_capture & PROMOTED_RANK;
-    BB right_promotion = right_capture & PROMOTED_RANK;
-    left_capture       = left_capture ^ left_promotion;
-    right_capture      = right_capture ^ right_promotion;
-
-    BuildPawnMoves(moves, left_capture, LEFT_DELTA[turn], Move::Capture);
-    BuildPawnMoves(moves, right_capture, RIGHT_DELTA[turn], Move::Capture);
-    BuildPromotionMoves(moves, left_promotion, LEFT_DELTA[turn], true);
-    BuildPromotionMoves(moves, right_promotion, RIGHT_DELTA[turn], true);
-
-    BB ep_pawns = PAWN_ATTACKS[!turn][ep] & pawns;
-    while (ep_pawns) [[unlikely]]
-        moves << Move(lsb_pop(ep_pawns), ep, Move::EPCapture);
+void GenerateMovesTactical(MoveList &moves, const Board &board, Color color) noexcept {
+    VisitMovesTactical(board, color, MoveCollector{moves});
 }
 
-void BuildMoves(MoveList &moves, Square ori, BB targets, Move::Type type) noexcept {
-    while (targets)
-        moves << Move(ori, lsb_pop(targets), type);
+void GenerateMovesAll(MoveList &moves, const Board &board, Color color) noexcept {
+    JANKCHESS_ZONE("GenerateMovesAll");
+    VisitMovesAll(board, color, MoveCollector{moves});
 }
 
-void BuildJumperMoves(
-    MoveList &moves, const std::array<BB, SQUARE_COUNT> &attacks, BB pieces, BB targets,
-    Move::Type type
-) noexcept {
-    while (pieces) {
-        const Square ori = lsb_pop(pieces);
-        BuildMoves(moves, ori, attacks[ori] & targets, type);
-    }
+MoveList GenerateMovesAll(const Board &board, Color color) noexcept {
+    MoveList moves;
+    GenerateMovesAll(moves, board, color);
+    return moves;
 }
 
-void GenerateSliderMoves(
-    MoveList &moves, const std::array<BB, SQUARE_COUNT> &attacks, BB pieces, BB targets, BB occ,
-    Move::Type type
-) noexcept {
-    while (pieces) {
-        const Square piece = lsb_pop(pieces);
-        BB unblocked       = attacks[piece];
-
-        for (int i = 1; i < 8 && unblocked; i++) {
-            BB p_ring    = RINGS[piece][i] & unblocked;
-            BB pot_moves = p_ring & targets;
-            BB blocked   = p_ring & occ;
+template <Color Us>
+bool IsPseudoLegal(const Board &board, Move move) noexcept {
+    const Square ori = move.Origin();
+    const Square dst = move.Destination();
+    if (!(board.Pieces(Us) & ori)) return false;
 
-            while (blocked)
-                unblocked &= ~SQ_RAYS[piece][lsb_pop(blocked)];
-
-            BuildMoves(moves, piece, pot_moves, type);
+    const BB occ   = board.Pieces();
+    const BB nus   = board.Pieces(!Us);
+    const BB empty = ~occ;
+    // Pawn and castling moves have types depending on more than the destination, so those of the
+    // piece are generated until the move is found
+    const auto differs = [move](Move generated) { return !(generated == move); };
+
+    BB attacks;
+    switch (board.SquarePiece(ori)) {
+    case PAWN:
+        return !VisitPawnTactical<Us>(differs, ToBB(ori), nus, board.EP()) ||
+               !VisitPawnQuiet<Us>(differs, ToBB(ori), empty, empty);
+    case KNIGHT: attacks = PSEUDO_ATTACKS[KNIGHT][ori]; break;
+    case BISHOP: attacks = BishopAttacks(ori, occ); break;
+    case ROOK: attacks = RookAttacks(ori, occ); break;
+    case QUEEN: attacks = BishopAttacks(ori, occ) | RookAttacks(ori, occ); break;
+    case KING:
+        if (move.IsCastle()) {
+            JANKCHESS_COUNT(COUNTER_CASTLING_ATTACKS);
+            return !VisitCastlingMoves<Us>(
+                differs, board.GetCastling(Us), occ, board.Attacks(!Us)
+            );
         }
+        attacks = PSEUDO_ATTACKS[KING][ori];
+        break;
+    default: return false;
     }
-}
 
-void GenerateCastlingMoves(MoveList &moves, const Board &board, Color color) noexcept {
-    static const Square KING_POS[2]         = {E1, E8};
-    static const Square KING_CASTLE_POS[2]  = {G1, G8};
-    static const Square QUEEN_CASTLE_POS[2] = {C1, C8};
-    static const BB KING_BLOCKERS[2]        = {ToBB(F1) | G1, ToBB(F8) | G8};
-    static const BB QUEEN_BLOCKERS[2]       = {ToBB(B1) | C1 | D1, ToBB(B8) | C8 | D8};
-    static const BB QUEEN_ATTACKERS[2]      = {ToBB(C1) | D1, ToBB(C8) | D8};
-
-    const Castling &castling = board.GetCastling(color);
-    const BB occ             = board.Pieces();
-    std::optional<BB> attacks;
-
-    if ((bool)(castling & Castling::King) && !(occ & KING_BLOCKERS[color])) {
-        attacks = board.GenerateAttacks(!color);
-        if (attacks.value() & KING_POS[color]) return;
-        if (!(attacks.value() & KING_BLOCKERS[color]))
-            moves << Move(KING_POS[color], KING_CASTLE_POS[color], Move::KingCastle);
-    }
-    if ((bool)(castling & Castling::Queen) && !(occ & QUEEN_BLOCKERS[color])) {
-        if (!attacks.has_value()) {
-            attacks = board.GenerateAttacks(!color);
-            if (attacks.value() & KING_POS[color]) return;
-        }
-        if (!(attacks.value() & QUEEN_ATTACKERS[color]))
-            moves << Move(KING_POS[color], QUEEN_CASTLE_POS[color], Move::QueenCastle);
+    switch (move.GetType()) {
+    case Move::Quiet: return attacks & empty & dst;
+    case Move::Capture: return attacks & nus & dst;
+    default: return false;
     }
 }
 
-void GenerateMovesQuiet(MoveList &moves, const Board &board, Color color) noexcept {
-    const BB us    = board.Pieces(color);
-    const BB nus   = board.Pieces(!color);
-    const BB occ   = board.Pieces();
-    const BB empty = ~occ;
+bool IsPseudoLegal(const Board &board, Move move) noexcept {
+    return board.Turn() == WHITE ? IsPseudoLegal<WHITE>(board, move)
+                                 : IsPseudoLegal<BLACK>(board, move);
+}
 
-    const BB pawns   = board.Pieces(color, PAWN);
-    const BB knights = board.Pieces(color, KNIGHT);
-    const BB kings   = board.Pieces(color, KING);
-    const BB bishops = board.Pieces(color, BISHOP) | board.Pieces(color, QUEEN);
-    const BB rooks   = board.Pieces(color, ROOK) | board.Pieces(color, QUEEN);
-
-    GeneratePawnQuiet(moves, color, pawns, empty);
-    GenerateSliderMoves(moves, PSEUDO_ATTACKS[BISHOP], bishops, empty, occ, Move::Quiet);
-    GenerateSliderMoves(moves, PSEUDO_ATTACKS[ROOK], rooks, empty, occ, Move::Quiet);
-    BuildJumperMoves(moves, PSEUDO_ATTACKS[KNIGHT], knights, empty, Move::Quiet);
-    BuildJumperMoves(moves, PSEUDO_ATTACKS[KING], kings, empty, Move::Quiet);
-    GenerateCastlingMoves(moves, board, color);
+// Returns the number of pawn moves onto the destinations, where each promotion is four moves
+template <Color Us>
+size_t CountPawnMoves(BB destinations) noexcept {
+    return popcount(destinations) + 3 * popcount(destinations & PROMOTED_RANK<Us>);
 }
 
-void GenerateMovesTactical(MoveList &moves, const Board &board, Color color) noexcept {
-    const BB us    = board.Pieces(color);
-    const BB nus   = board.Pieces(!color);
-    const BB occ   = board.Pieces();
-    const BB empty = ~occ;
+template <Color Us, typename B>
+size_t CountLegal(const B &board) noexcept {
+    const LegalMasks masks = ComputeLegalMasks<Us>(board);
+    const Square king      = masks.king;
+    const BB occ           = board.Pieces();
+    const BB empty         = ~occ;
+    const BB targets       = masks.captures | masks.quiets;
+
+    size_t count = popcount(PSEUDO_ATTACKS[KING][king] & ~board.Pieces(Us) & ~masks.danger);
+
+    // In double check only the king may move
+    if (popcount(masks.checkers) > 1) return count;
+
+    const BB free  = ~masks.pinned;
+    const BB pawns = board.Pieces(Us, PAWN);
+    BB knights     = board.Pieces(Us, KNIGHT) & free;
+    BB bishops     = (board.Pieces(Us, BISHOP) | board.Pieces(Us, QUEEN)) & free;
+    BB rooks       = (board.Pieces(Us, ROOK) | board.Pieces(Us, QUEEN)) & free;
+
+    const auto [advanced, advanced_twice] = PawnPushes<Us>(pawns & free, empty, masks.quiets);
+    const auto [left_capture, right_capture] = PawnCaptures<Us>(pawns & free, masks.captures);
+    count += CountPawnMoves<Us>(advanced) + popcount(advanced_twice);
+    count += CountPawnMoves<Us>(left_capture) + CountPawnMoves<Us>(right_capture);
+    count += popcount(LegalEPPawns<Us>(board, king, pawns, masks.checkers));
+
+    while (knights)
+        count += popcount(PSEUDO_ATTACKS[KNIGHT][lsb_pop(knights)] & targets);
+    while (bishops)
+        count += popcount(BishopAttacks(lsb_pop(bishops), occ) & targets);
+    while (rooks)
+        count += popcount(RookAttacks(lsb_pop(rooks), occ) & targets);
+
+    for (BB pinned = masks.pinned & ~board.Pieces(KNIGHT); pinned;) {
+        const Square piece = lsb_pop(pinned);
+        const BB ray       = SQ_RAYS[king][piece];
+        if (piece & pawns) {
+            const auto [push, push_twice] =
+                PawnPushes<Us>(ToBB(piece), empty, masks.quiets & ray);
+            const auto [left, right] = PawnCaptures<Us>(ToBB(piece), masks.captures & ray);
+            count += CountPawnMoves<Us>(push) + popcount(push_twice);
+            count += CountPawnMoves<Us>(left) + CountPawnMoves<Us>(right);
+        } else
+            count += popcount(PinnedSliderTargets(board, king, piece) & targets);
+    }
 
-    const BB pawns   = board.Pieces(color, PAWN);
-    const BB knights = board.Pieces(color, KNIGHT);
-    const BB kings   = board.Pieces(color, KING);
-    const BB bishops = board.Pieces(color, BISHOP) | board.Pieces(color, QUEEN);
-    const BB rooks   = board.Pieces(color, ROOK) | board.Pieces(color, QUEEN);
-
-    GeneratePawnTactical(moves, color, pawns, nus, board.EP());
-    GenerateSliderMoves(moves, PSEUDO_ATTACKS[BISHOP], bishops, nus, occ, Move::Capture);
-    GenerateSliderMoves(moves, PSEUDO_ATTACKS[ROOK], rooks, nus, occ, Move::Capture);
-    BuildJumperMoves(moves, PSEUDO_ATTACKS[KNIGHT], knights, nus, Move::Capture);
-    BuildJumperMoves(moves, PSEUDO_ATTACKS[KING], kings, nus, Move::Capture);
+    if (!masks.checkers) {
+        const Castling castling = LegalCastling<Us>(board.GetCastling(Us), occ, masks.danger);
+        count += (bool)(castling & Castling::King) + (bool)(castling & Castling::Queen);
+    }
+
+    return count;
 }
 
-void GenerateMovesAll(MoveList &moves, const Board &board, Color color) noexcept {
-    GenerateMovesTactical(moves, board, color);
-    GenerateMovesQuiet(moves, board, color);
+void GenerateMovesLegal(MoveList &moves, const Board &board, Color color) noexcept {
+    JANKCHESS_ZONE("GenerateMovesLegal");
+    VisitMovesLegal(board, color, MoveCollector{moves});
 }
 
-MoveList GenerateMovesAll(const Board &board, Color color) noexcept {
+void GenerateMovesLegal(MoveList &moves, const Position &position, Color color) noexcept {
+    VisitMovesLegal(position, color, MoveCollector{moves});
+}
+
+MoveList GenerateMovesLegal(const Board &board, Color color) noexcept {
     MoveList moves;
-    GenerateMovesAll(moves, board, color);
+    GenerateMovesLegal(moves, board, color);
+    return moves;
+}
+
+MoveList GenerateMovesLegal(const Position &position, Color color) noexcept {
+    MoveList moves;
+    GenerateMovesLegal(moves, position, color);
     return moves;
 }
+
+size_t CountMovesLegal(const Board &board, Color color) noexcept {
+    return color == WHITE ? CountLegal<WHITE>(board) : CountLegal<BLACK>(board);
+}
+
+size_t CountMovesLegal(const Position &position, Color color) noexcept {
+    return color == WHITE ? CountLegal<WHITE>(position) : CountLegal<BLACK>(position);
+}
 } // namespace Chess
@@ -0,0 +1,95 @@
+#include <JankChess/move_picker.hpp>
+#include <JankChess/see.hpp>
+#include <utility>
+
+namespace Chess {
+MovePicker::MovePicker(const Board &board, Move hash_move, std::array<Move, 2> killers) noexcept
+    : board(board), hash_move(hash_move), killers(killers) {}
+
+MovePicker MovePicker::Tactical(const Board &board) noexcept {
+    MovePicker picker(board);
+    picker.stage         = Stage::GenerateCaptures;
+    picker.tactical_only = true;
+    return picker;
+}
+
+Move MovePicker::PickBestCapture() noexcept {
+    size_t best = index;
+    for (size_t i = index + 1; i < moves.size(); i++)
+        if (scores[i] > scores[best]) best = i;
+    std::swap(scores[index], scores[best]);
+    std::swap(moves[index], moves[best]);
+    return moves[index++];
+}
+
+Move MovePicker::Next() noexcept {
+    switch (stage) {
+    case Stage::HashMove:
+        stage = Stage::GenerateCaptures;
+        if (!(hash_move == Move()) && IsPseudoLegal(board, hash_move)) return hash_move;
+        [[fallthrough]];
+    case Stage::GenerateCaptures:
+        GenerateMovesTactical(moves, board, board.Turn());
+        for (size_t i = 0; i < moves.size(); i++) {
+            const Move move      = moves[i];
+            const Square dst     = move.Destination();
+            // En passant is the only capture onto an empty square
+            const Piece victim   = move.IsEnPassant() ? PAWN : board.SquarePiece(dst);
+            const Piece attacker = board.SquarePiece(move.Origin());
+            scores[i]            = PIECE_COUNT * victim - attacker;
+        }
+        stage = Stage::Captures;
+        [[fallthrough]];
+    case Stage::Captures:
+        while (index < moves.size()) {
+            const Move move = PickBestCapture();
+            if (move == hash_move) continue;
+            // Taking a piece of at least equal value cannot lose material, so needs no exchange
+            const Square dst     = move.Destination();
+            const Piece victim   = move.IsEnPassant() ? PAWN : board.SquarePiece(dst);
+            const Piece attacker = board.SquarePiece(move.Origin());
+            if (victim != PIECE_NONE && SEE_VALUES[victim] < SEE_VALUES[attacker] &&
+                SEE(board, move) < 0) {
+                std::swap(moves[bad_count++], moves[index - 1]);
+                continue;
+            }
+            return move;
+        }
+        if (tactical_only) {
+            stage = Stage::Done;
+            return Move();
+        }
+        stage = Stage::Killers;
+        [[fallthrough]];
+    case Stage::Killers:
+        while (killer_index < killers.size()) {
+            const Move killer = killers[killer_index++];
+            if (killer == Move() || killer == hash_move || killer.IsCapture()) continue;
+            if (killer_index == 2 && killer == killers[0]) continue;
+            if (IsPseudoLegal(board, killer)) return killer;
+        }
+        stage = Stage::GenerateQuiets;
+        [[fallthrough]];
+    case Stage::GenerateQuiets:
+        index = moves.size();
+        GenerateMovesQuiet(moves, board, board.Turn());
+        stage = Stage::Quiets;
+        [[fallthrough]];
+    case Stage::Quiets:
+        while (index < moves.size()) {
+            const Move move = moves[index++];
+            if (move == hash_move || move == killers[0] || move == killers[1]) continue;
+            return move;
+        }
+        stage = Stage::BadCaptures;
+        index = 0;
+        [[fallthrough]];
+    case Stage::BadCaptures:
+        if (index < bad_count) return moves[index++];
+        stage = Stage::Done;
+        [[fallthrough]];
+    case Stage::Done: return Move();
+    }
+    return Move();
+}
+} // namespace Chess
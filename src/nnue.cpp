@@ -0,0 +1,177 @@
+#include <JankChess/bb.hpp>
+#include <JankChess/board.hpp>
+#include <JankChess/nnue.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Chess {
+// The kernels are chosen at compile time, such that a native build uses the widest available,
+// whereas a distributable falls back to SSE2, which every x86-64 CPU supports
+#if defined(__AVX2__)
+constexpr size_t LANES = 16;
+#elif defined(__SSE2__)
+constexpr size_t LANES = 8;
+#else
+constexpr size_t LANES = 1;
+#endif
+static_assert(NNUE_HIDDEN % LANES == 0);
+
+const char *NNUEKernelName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// Index of the input of a piece as seen by perspective, where pieces of the perspective come first
+// and the board is mirrored for black, such that both perspectives share weights
+static size_t FeatureIndex(Color perspective, Color color, Piece piece, Square square) {
+    const size_t relative_square = static_cast<size_t>(square) ^ (perspective == WHITE ? 0 : 56);
+    return ((color != perspective) * PIECE_COUNT + piece) * SQUARE_COUNT + relative_square;
+}
+
+// Adds, or subtracts, a row of weights to the values of the hidden layer
+template <bool Add>
+static void UpdateHidden(int16_t *values, const int16_t *row) {
+    for (size_t i = 0; i < NNUE_HIDDEN; i += LANES) {
+#if defined(__AVX2__)
+        const __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i *>(values + i));
+        const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_store_si256(
+            reinterpret_cast<__m256i *>(values + i),
+            Add ? _mm256_add_epi16(v, w) : _mm256_sub_epi16(v, w)
+        );
+#elif defined(__SSE2__)
+        const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i w = _mm_load_si128(reinterpret_cast<const __m128i *>(row + i));
+        _mm_store_si128(
+            reinterpret_cast<__m128i *>(values + i), Add ? _mm_add_epi16(v, w) : _mm_sub_epi16(v, w)
+        );
+#else
+        values[i] = Add ? values[i] + row[i] : values[i] - row[i];
+#endif
+    }
+}
+
+// Returns the dot product of the activated values of the hidden layer and the output weights
+static int32_t OutputDot(const int16_t *values, const int16_t *weights) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa   = _mm256_set1_epi16(NNUE_QA);
+    __m256i sum        = _mm256_setzero_si256();
+    for (size_t i = 0; i < NNUE_HIDDEN; i += LANES) {
+        __m256i v       = _mm256_load_si256(reinterpret_cast<const __m256i *>(values + i));
+        const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i *>(weights + i));
+        v               = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+        sum             = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+    }
+    __m128i total = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa   = _mm_set1_epi16(NNUE_QA);
+    __m128i total      = _mm_setzero_si128();
+    for (size_t i = 0; i < NNUE_HIDDEN; i += LANES) {
+        __m128i v       = _mm_load_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i w = _mm_load_si128(reinterpret_cast<const __m128i *>(weights + i));
+        v               = _mm_min_epi16(_mm_max_epi16(v, zero), qa);
+        total           = _mm_add_epi32(total, _mm_madd_epi16(v, w));
+    }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4e));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xb1));
+    return _mm_cvtsi128_si32(total);
+#else
+    int32_t sum = 0;
+    for (size_t i = 0; i < NNUE_HIDDEN; i++)
+        sum += std::clamp<int32_t>(values[i], 0, NNUE_QA) * weights[i];
+    return sum;
+#endif
+}
+
+std::unique_ptr<Network> Network::Load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return nullptr;
+    const std::vector<char> bytes(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()
+    );
+
+    constexpr size_t COUNT = NNUE_INPUTS * NNUE_HIDDEN + NNUE_HIDDEN + 2 * NNUE_HIDDEN + 1;
+    if (bytes.size() != 2 * COUNT) return nullptr;
+
+    // Read byte by byte, such that the file is little-endian regardless of the host
+    size_t offset = 0;
+    const auto next = [&] {
+        const auto lo = static_cast<uint8_t>(bytes[offset++]);
+        const auto hi = static_cast<uint8_t>(bytes[offset++]);
+        return static_cast<int16_t>(lo | hi << 8);
+    };
+    auto network = std::make_unique<Network>();
+    for (auto &row : network->feature_weights)
+        for (auto &weight : row)
+            weight = next();
+    for (auto &bias : network->feature_bias)
+        bias = next();
+    for (auto &weight : network->output_weights)
+        weight = next();
+    network->output_bias = next();
+    return network;
+}
+
+AccumulatorStack::AccumulatorStack(std::shared_ptr<const Network> network)
+    : network(std::move(network)), accumulators(MAX_PLY) {}
+
+void AccumulatorStack::Refresh(const Board &board, size_t ply) noexcept {
+    for (const auto perspective : {WHITE, BLACK})
+        accumulators[ply % MAX_PLY].values[perspective] = network->feature_bias;
+    for (const auto color : {WHITE, BLACK})
+        for (const auto piece : PIECES) {
+            BB pieces = board.Pieces(color, piece);
+            while (pieces)
+                Add(ply, color, piece, lsb_pop(pieces));
+        }
+}
+
+void AccumulatorStack::Push(size_t ply) noexcept {
+    accumulators[ply % MAX_PLY] = accumulators[(ply - 1) % MAX_PLY];
+}
+
+void AccumulatorStack::Add(size_t ply, Color color, Piece piece, Square square) noexcept {
+    for (const auto perspective : {WHITE, BLACK})
+        UpdateHidden<true>(
+            accumulators[ply % MAX_PLY].values[perspective].data(),
+            network->feature_weights[FeatureIndex(perspective, color, piece, square)].data()
+        );
+}
+
+void AccumulatorStack::Remove(size_t ply, Color color, Piece piece, Square square) noexcept {
+    for (const auto perspective : {WHITE, BLACK})
+        UpdateHidden<false>(
+            accumulators[ply % MAX_PLY].values[perspective].data(),
+            network->feature_weights[FeatureIndex(perspective, color, piece, square)].data()
+        );
+}
+
+int AccumulatorStack::Evaluate(size_t ply, Color turn) const noexcept {
+    const Accumulator &accumulator = accumulators[ply % MAX_PLY];
+    const int32_t output =
+        OutputDot(accumulator.values[turn].data(), network->output_weights.data()) +
+        OutputDot(accumulator.values[!turn].data(), network->output_weights.data() + NNUE_HIDDEN) +
+        network->output_bias * NNUE_QA;
+    return static_cast<int64_t>(output) * NNUE_SCALE / (NNUE_QA * NNUE_QB);
+}
+
+const Accumulator &AccumulatorStack::operator[](size_t ply) const noexcept {
+    return accumulators[ply % MAX_PLY];
+}
+} // namespace Chess
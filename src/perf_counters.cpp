@@ -0,0 +1,93 @@
+#include <JankChess/perf_counters.hpp>
+#include <utility>
+
+#ifdef JANKCHESS_PERF_COUNTERS
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Chess {
+#ifdef JANKCHESS_PERF_COUNTERS
+// The type and config of each event, where misses of the L1 data cache are only counted on reads
+constexpr std::array<std::pair<uint32_t, uint64_t>, PERF_EVENT_COUNT> PERF_EVENT_CONFIGS = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+
+PerfCounters::PerfCounters() noexcept {
+    int error = 0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        perf_event_attr attr = {};
+        attr.size            = sizeof(attr);
+        attr.type            = PERF_EVENT_CONFIGS[i].first;
+        attr.config          = PERF_EVENT_CONFIGS[i].second;
+        attr.disabled        = 1;
+        attr.inherit         = 1;
+        attr.exclude_kernel  = 1;
+        attr.exclude_hv      = 1;
+        // Events are opened separately rather than as a group, as groups cannot be inherited,
+        // hence each is scaled by its own share of time on the PMU
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i]           = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[i] < 0) error = errno;
+    }
+    if (!Available()) fprintf(stderr, "perf counters unavailable: %s\n", strerror(error));
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int fd : fds)
+        if (fd >= 0) close(fd);
+}
+
+bool PerfCounters::Available() const noexcept {
+    for (const int fd : fds)
+        if (fd >= 0) return true;
+    return false;
+}
+
+void PerfCounters::Start() noexcept {
+    for (const int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfCounts PerfCounters::Stop() noexcept {
+    for (const int fd : fds)
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    PerfCounts counts;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        // Value, time enabled, time running
+        uint64_t data[3];
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+            continue;
+        counts.counts[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+        counts.valid[i]  = true;
+    }
+    return counts;
+}
+#endif
+
+void PrintPerfCounts(FILE *file, const PerfCounts &counts, size_t operations, const char *unit) {
+    const double divisor = static_cast<double>(operations > 0 ? operations : 1);
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++)
+        if (counts.valid[i])
+            fprintf(file, " %s/%s %.2f", PERF_EVENT_NAMES[i], unit, counts.counts[i] / divisor);
+    if (counts.valid[PERF_CYCLES] && counts.valid[PERF_INSTRUCTIONS] && counts.counts[PERF_CYCLES])
+        fprintf(
+            file, " ipc %.2f",
+            static_cast<double>(counts.counts[PERF_INSTRUCTIONS]) / counts.counts[PERF_CYCLES]
+        );
+    fprintf(file, "\n");
+}
+} // namespace Chess
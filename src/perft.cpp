@@ -0,0 +1,17 @@
+#include <JankChess/perft.hpp>
+
+namespace Chess {
+void detail::SplitPerft(Board &board, int split, PerftTask &task, std::vector<PerftTask> &tasks) {
+    if (static_cast<int>(task.path.size()) == split) {
+        tasks.push_back(task);
+        return;
+    }
+    for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+        board.ApplyMove(move);
+        task.path.push_back(move);
+        SplitPerft(board, split, task, tasks);
+        task.path.pop_back();
+        board.UndoMove(move);
+    }
+}
+} // namespace Chess
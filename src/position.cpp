@@ -0,0 +1,171 @@
+#include <JankChess/bb.hpp>
+#include <JankChess/masks.hpp>
+#include <JankChess/position.hpp>
+#include <JankChess/zobrist.hpp>
+
+namespace Chess {
+// CONSTRUCTOR
+
+Position::Position(const Board &board) noexcept {
+    for (const auto piece : PIECES)
+        this->pieces[piece] = board.Pieces(piece);
+    for (const auto color : {WHITE, BLACK})
+        this->colors[color] = board.Pieces(color);
+    for (const auto sq : SQUARES)
+        SetSquarePiece(sq, board.SquarePiece(sq));
+    this->castling = 0;
+    for (const auto color : {WHITE, BLACK})
+        SetCastling(color, board.GetCastling(color));
+    this->hash = board.GetHash();
+    this->turn = board.Turn();
+    this->ep   = board.EP();
+}
+
+Position::Position(const std::string &FEN) noexcept : Position(Board(FEN)) {}
+
+// ACCESS
+
+Color Position::Turn() const noexcept { return static_cast<Color>(this->turn); }
+Square Position::EP() const noexcept { return static_cast<Square>(this->ep); }
+Castling Position::GetCastling(Color color) const noexcept {
+    return static_cast<Castling>((this->castling >> (2 * color)) & 3);
+}
+Hash Position::GetHash() const noexcept { return this->hash; }
+BB Position::Pieces() const noexcept { return Pieces(WHITE) | Pieces(BLACK); }
+BB Position::Pieces(Piece piece) const noexcept { return this->pieces[piece]; }
+BB Position::Pieces(Color color) const noexcept { return this->colors[color]; }
+BB Position::Pieces(Color color, Piece piece) const noexcept {
+    return Pieces(color) & Pieces(piece);
+}
+Piece Position::SquarePiece(Square square) const noexcept {
+    return static_cast<Piece>((this->mailbox[square / 2] >> (4 * (square % 2))) & 0xf);
+}
+
+BB Position::GenerateAttacks(Color color, BB occ) const noexcept {
+    BB pawns   = Pieces(color, PAWN);
+    BB knights = Pieces(color, KNIGHT);
+    BB kings   = Pieces(color, KING);
+    BB bishops = Pieces(color, BISHOP) | Pieces(color, QUEEN);
+    BB rooks   = Pieces(color, ROOK) | Pieces(color, QUEEN);
+
+    BB attacks = 0;
+
+    while (pawns)
+        attacks |= PAWN_ATTACKS[color][lsb_pop(pawns)];
+    while (knights)
+        attacks |= PSEUDO_ATTACKS[KNIGHT][lsb_pop(knights)];
+    while (kings)
+        attacks |= PSEUDO_ATTACKS[KING][lsb_pop(kings)];
+    while (bishops)
+        attacks |= BishopAttacks(lsb_pop(bishops), occ);
+    while (rooks)
+        attacks |= RookAttacks(lsb_pop(rooks), occ);
+
+    return attacks;
+}
+
+// MODIFIERS
+
+void Position::SetSquarePiece(Square square, Piece piece) noexcept {
+    const int shift = 4 * (square % 2);
+    uint8_t &pair   = this->mailbox[square / 2];
+    pair            = (pair & ~(0xf << shift)) | (piece << shift);
+}
+void Position::SetCastling(Color color, Castling castling) noexcept {
+    const int shift = 2 * color;
+    this->castling  = (this->castling & ~(3 << shift)) | (static_cast<int>(castling) << shift);
+}
+void Position::PlacePiece(Color color, Piece piece, Square square) noexcept {
+    this->colors[color] ^= square;
+    this->pieces[piece] ^= square;
+    this->hash = FlipSquare(this->hash, color, piece, square);
+    SetSquarePiece(square, piece);
+}
+void Position::RemovePiece(Color color, Piece piece, Square square) noexcept {
+    this->colors[color] ^= square;
+    this->pieces[piece] ^= square;
+    this->hash = FlipSquare(this->hash, color, piece, square);
+    SetSquarePiece(square, PIECE_NONE);
+}
+
+Position Position::Apply(Move move) const noexcept {
+    return Turn() == WHITE ? Apply<WHITE>(move) : Apply<BLACK>(move);
+}
+
+template <Color Us>
+Position Position::Apply(Move move) const noexcept {
+    assert(Turn() == Us);
+    constexpr Color us   = Us;
+    constexpr Color nus  = !Us;
+    Position next        = *this;
+    const Square ori     = move.Origin();
+    const Square dst     = move.Destination();
+    Piece piece          = SquarePiece(ori);
+    Square target_square = dst;
+    Square ep            = SQUARE_NONE;
+    Castling castling[2] = {GetCastling(WHITE), GetCastling(BLACK)};
+
+    next.RemovePiece(us, piece, ori);
+
+    switch (move.GetType()) {
+    case Move::KingCastle:
+    case Move::QueenCastle: {
+        const Square ROOK_ORI[2][2] = {{A1, A8}, {H1, H8}};
+        const Square ROOK_DST[2][2] = {{D1, D8}, {F1, F8}};
+        const bool king_side        = dst > ori;
+        next.RemovePiece(us, ROOK, ROOK_ORI[king_side][us]);
+        next.PlacePiece(us, ROOK, ROOK_DST[king_side][us]);
+        break;
+    }
+    case Move::NPromotion: piece = KNIGHT; break;
+    case Move::BPromotion: piece = BISHOP; break;
+    case Move::RPromotion: piece = ROOK; break;
+    case Move::QPromotion: piece = QUEEN; break;
+    case Move::NPromotionCapture: piece = KNIGHT; goto CAPTURE;
+    case Move::BPromotionCapture: piece = BISHOP; goto CAPTURE;
+    case Move::RPromotionCapture: piece = ROOK; goto CAPTURE;
+    case Move::QPromotionCapture: piece = QUEEN; goto CAPTURE;
+    case Move::EPCapture: target_square = static_cast<Square>(EP() + (Us == WHITE ? -8 : 8));
+    case Move::Capture: {
+    CAPTURE:
+        next.RemovePiece(nus, SquarePiece(target_square), target_square);
+        if (target_square == CORNER_A[nus])
+            castling[nus] &= Castling::King;
+        else if (target_square == CORNER_H[nus])
+            castling[nus] &= Castling::Queen;
+        break;
+    }
+    case Move::DoublePawnPush: ep = static_cast<Square>(Us == WHITE ? ori + 8 : ori - 8); break;
+    default: break;
+    }
+
+    next.PlacePiece(us, piece, dst);
+
+    if (piece == KING) [[unlikely]]
+        castling[us] = Castling::None;
+    else if (piece == ROOK) [[unlikely]] {
+        if (ori == CORNER_A[us])
+            castling[us] &= Castling::King;
+        else if (ori == CORNER_H[us])
+            castling[us] &= Castling::Queen;
+    }
+
+    if (EP() != ep) {
+        next.hash = FlipEnpassant(next.hash, EP());
+        next.hash = FlipEnpassant(next.hash, ep);
+    }
+    for (const auto color : {WHITE, BLACK})
+        if (castling[color] != GetCastling(color)) [[unlikely]] {
+            next.hash = FlipCastle(next.hash, color, GetCastling(color));
+            next.hash = FlipCastle(next.hash, color, castling[color]);
+            next.SetCastling(color, castling[color]);
+        }
+
+    next.ep   = ep;
+    next.turn = nus;
+    next.hash = FlipTurn(next.hash);
+    return next;
+}
+template Position Position::Apply<WHITE>(Move move) const noexcept;
+template Position Position::Apply<BLACK>(Move move) const noexcept;
+} // namespace Chess
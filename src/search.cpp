@@ -0,0 +1,276 @@
+#include <JankChess/eval.hpp>
+#include <JankChess/instrument.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/move_picker.hpp>
+#include <JankChess/search.hpp>
+#include <algorithm>
+#include <thread>
+
+namespace Chess {
+// Mate scores are stored relative to the position, rather than the root, as positions are
+// reached at different plies
+int ScoreToTT(int score, int ply) {
+    if (score >= SCORE_MATE - MAX_DEPTH) return score + ply;
+    if (score <= -SCORE_MATE + MAX_DEPTH) return score - ply;
+    return score;
+}
+
+int ScoreFromTT(int score, int ply) {
+    if (score >= SCORE_MATE - MAX_DEPTH) return score - ply;
+    if (score <= -SCORE_MATE + MAX_DEPTH) return score + ply;
+    return score;
+}
+
+Searcher::Searcher(size_t hash_mb, size_t thread_count) : tt(hash_mb), stop(false) {
+    SetThreads(thread_count);
+}
+
+void Searcher::Stop() noexcept { stop = true; }
+
+void Searcher::Clear() noexcept {
+    tt.Clear();
+    for (auto &thread : threads)
+        thread.killers = {};
+}
+
+void Searcher::SetThreads(size_t thread_count) {
+    threads = std::vector<Thread>(std::max<size_t>(thread_count, 1));
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].id      = i;
+        threads[i].nodes   = 0;
+        threads[i].killers = {};
+    }
+    SetNetwork(network);
+}
+
+size_t Searcher::ThreadCount() const noexcept { return threads.size(); }
+
+void Searcher::SetHash(size_t hash_mb) { tt = TranspositionTable(hash_mb); }
+
+void Searcher::SetNetwork(std::shared_ptr<const Network> network) {
+    this->network = network;
+    for (auto &thread : threads)
+        thread.accumulators = network ? std::make_unique<AccumulatorStack>(network) : nullptr;
+}
+
+size_t Searcher::Nodes() const noexcept {
+    size_t nodes = 0;
+    for (const auto &thread : threads)
+        nodes += thread.nodes.load(std::memory_order_relaxed);
+    return nodes;
+}
+
+size_t Searcher::ElapsedMs() const noexcept {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+bool Searcher::CheckLimits(Thread &thread) noexcept {
+    // Only the owning thread writes the count, so it need not be incremented atomically
+    const size_t nodes = thread.nodes.load(std::memory_order_relaxed) + 1;
+    thread.nodes.store(nodes, std::memory_order_relaxed);
+    if (thread.node_limit && nodes >= thread.node_limit) stop = true;
+    // The clock is costly to read, so only do so periodically
+    if (limits.time && (nodes & 1023) == 0 && ElapsedMs() >= limits.time) stop = true;
+    return stop.load(std::memory_order_relaxed);
+}
+
+void Searcher::UpdatePV(Thread &thread, int ply, Move move) noexcept {
+    thread.pv[ply][ply] = move;
+    for (int i = ply + 1; i < thread.pv_length[ply + 1]; i++)
+        thread.pv[ply][i] = thread.pv[ply + 1][i];
+    thread.pv_length[ply] = std::max(thread.pv_length[ply + 1], ply + 1);
+}
+
+SearchResult Searcher::Search(
+    const Board &board, const SearchLimits &limits,
+    const std::function<void(const SearchResult &)> &on_iteration
+) {
+    this->limits = limits;
+    this->start  = std::chrono::steady_clock::now();
+    this->stop   = false;
+
+    // The node limit is split evenly between threads, such that it is never exceeded in total
+    for (auto &thread : threads) {
+        const size_t share = limits.nodes / threads.size();
+        thread.board       = board;
+        thread.nodes       = 0;
+        thread.node_limit  = limits.nodes ? std::max<size_t>(share, 1) : 0;
+        thread.board.AttachAccumulators(thread.accumulators.get());
+    }
+    threads[0].node_limit += limits.nodes ? limits.nodes % threads.size() : 0;
+
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < threads.size(); i++)
+        helpers.emplace_back([this, i] { SearchHelper(threads[i]); });
+
+    Thread &main = threads[0];
+    SearchResult result;
+    // Should the first iteration not complete, any legal move is better than none
+    const MoveList legal = GenerateMovesLegal(board, board.Turn());
+    if (legal.size() > 0) result.best_move = legal[0];
+
+    const int max_depth = std::clamp(limits.depth, 1, MAX_DEPTH - 1);
+    for (int depth = 1; depth <= max_depth; depth++) {
+        const int score = AlphaBeta(main, -SCORE_INFINITE, SCORE_INFINITE, depth, 0);
+        if (stop) break;
+
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(main.pv[0].begin(), main.pv[0].begin() + main.pv_length[0]);
+        if (!result.pv.empty()) result.best_move = result.pv[0];
+        result.nodes = Nodes();
+        result.time  = ElapsedMs();
+        result.nps   = result.nodes * 1000 / std::max<size_t>(result.time, 1);
+        if (on_iteration) on_iteration(result);
+
+        // Searching deeper cannot find a shorter mate
+        if (IsMateScore(score) && SCORE_MATE - std::abs(score) <= depth) break;
+    }
+
+    stop = true;
+    for (auto &helper : helpers)
+        helper.join();
+
+    result.nodes = Nodes();
+    result.time  = ElapsedMs();
+    result.nps   = result.nodes * 1000 / std::max<size_t>(result.time, 1);
+    result.thread_nodes.clear();
+    for (const auto &thread : threads)
+        result.thread_nodes.push_back(thread.nodes);
+    return result;
+}
+
+void Searcher::SearchHelper(Thread &thread) noexcept {
+    // Every other helper searches a ply deeper than the main thread, such that the threads diverge
+    // rather than all searching the same tree in the same order
+    for (int depth = 1 + thread.id % 2; depth < MAX_DEPTH && !stop; depth++)
+        AlphaBeta(thread, -SCORE_INFINITE, SCORE_INFINITE, depth, 0);
+}
+
+int Searcher::AlphaBeta(Thread &thread, int alpha, int beta, int depth, int ply) noexcept {
+    Board &board          = thread.board;
+    thread.pv_length[ply] = ply;
+    // A position repeated once is scored as a draw, as either side could repeat it again
+    if (ply > 0 && board.IsRepetition()) return 0;
+    const Color us      = board.Turn();
+    const bool in_check = !board.IsKingSafe(us);
+    // A checkmate upon the last move takes precedence over the draw
+    if (ply > 0 && board.IsFiftyMoveDraw())
+        return in_check && CountMovesLegal(board, us) == 0 ? -SCORE_MATE + ply : 0;
+    // Checks are searched deeper, such that the resolution of the check is not beyond the horizon,
+    // including checks upon the horizon itself
+    if (in_check) depth++;
+    if (depth <= 0) return Quiescence(thread, alpha, beta, ply);
+    if (CheckLimits(thread)) return 0;
+    if (ply >= MAX_DEPTH - 1) return Evaluate(board);
+
+    const bool pv_node = beta - alpha > 1;
+    const Hash hash    = board.GetHash();
+    Move hash_move     = Move();
+    if (const auto entry = tt.Probe(hash)) {
+        hash_move       = entry->move;
+        const int score = ScoreFromTT(entry->score, ply);
+        if (!pv_node && ply > 0 && entry->depth >= depth &&
+            (entry->bound == Bound::Exact || (entry->bound == Bound::Lower && score >= beta) ||
+             (entry->bound == Bound::Upper && score <= alpha)))
+            return score;
+    }
+
+    const int original_alpha = alpha;
+    int best                 = -SCORE_INFINITE;
+    Move best_move           = Move();
+    size_t legal             = 0;
+
+    MovePicker picker(board, hash_move, thread.killers[ply]);
+    for (Move move = picker.Next(); !(move == Move()); move = picker.Next()) {
+        board.ApplyMove(move);
+        if (!board.IsKingSafe(us)) {
+            JANKCHESS_COUNT(COUNTER_ILLEGAL_MOVES);
+            board.UndoMove(move);
+            continue;
+        }
+        legal++;
+
+        // Moves after the first are expected to be worse, which is proven by a null window search
+        int score;
+        if (legal == 1)
+            score = -AlphaBeta(thread, -beta, -alpha, depth - 1, ply + 1);
+        else {
+            score = -AlphaBeta(thread, -alpha - 1, -alpha, depth - 1, ply + 1);
+            if (score > alpha && score < beta)
+                score = -AlphaBeta(thread, -beta, -alpha, depth - 1, ply + 1);
+        }
+        board.UndoMove(move);
+        if (stop) return 0;
+
+        if (score <= best) continue;
+        best      = score;
+        best_move = move;
+        if (score <= alpha) continue;
+        alpha = score;
+        UpdatePV(thread, ply, move);
+        if (alpha >= beta) {
+            if (!move.IsCapture() && !(move == thread.killers[ply][0])) {
+                thread.killers[ply][1] = thread.killers[ply][0];
+                thread.killers[ply][0] = move;
+            }
+            break;
+        }
+    }
+
+    if (legal == 0) return in_check ? -SCORE_MATE + ply : 0;
+
+    Bound bound = Bound::Exact;
+    if (best >= beta)
+        bound = Bound::Lower;
+    else if (best <= original_alpha)
+        bound = Bound::Upper;
+    tt.Store(hash, best_move, ScoreToTT(best, ply), depth, bound);
+    return best;
+}
+
+int Searcher::Quiescence(Thread &thread, int alpha, int beta, int ply) noexcept {
+    Board &board          = thread.board;
+    thread.pv_length[ply] = ply;
+    if (CheckLimits(thread)) return 0;
+
+    if (ply >= MAX_DEPTH - 1) return Evaluate(board);
+
+    // The side to move may decline every capture, so the static evaluation is a lower bound, unless
+    // in check, in which case every evasion is searched instead
+    const Color us      = board.Turn();
+    const bool in_check = !board.IsKingSafe(us);
+    int best            = -SCORE_INFINITE;
+    if (!in_check) {
+        best = Evaluate(board);
+        if (best >= beta) return best;
+        alpha = std::max(alpha, best);
+    }
+
+    MovePicker picker = in_check ? MovePicker(board) : MovePicker::Tactical(board);
+    size_t legal      = 0;
+    for (Move move = picker.Next(); !(move == Move()); move = picker.Next()) {
+        board.ApplyMove(move);
+        if (!board.IsKingSafe(us)) {
+            JANKCHESS_COUNT(COUNTER_ILLEGAL_MOVES);
+            board.UndoMove(move);
+            continue;
+        }
+        legal++;
+        const int score = -Quiescence(thread, -beta, -alpha, ply + 1);
+        board.UndoMove(move);
+        if (stop) return 0;
+
+        if (score <= best) continue;
+        best = score;
+        if (score <= alpha) continue;
+        alpha = score;
+        UpdatePV(thread, ply, move);
+        if (alpha >= beta) break;
+    }
+
+    if (in_check && legal == 0) return -SCORE_MATE + ply;
+    return best;
+}
+} // namespace Chess
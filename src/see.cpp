@@ -0,0 +1,71 @@
+#include <JankChess/bb.hpp>
+#include <JankChess/masks.hpp>
+#include <JankChess/see.hpp>
+#include <algorithm>
+
+namespace Chess {
+int SEE(const Board &board, Move move) noexcept {
+    const Square ori = move.Origin();
+    const Square dst = move.Destination();
+    const Color us   = board.Turn();
+    BB occ           = board.Pieces() ^ ori;
+
+    Piece victim = board.SquarePiece(dst);
+    if (move.IsEnPassant()) {
+        victim = PAWN;
+        occ ^= static_cast<Square>(dst + (us == WHITE ? -8 : 8));
+    }
+    // The piece left on the destination, and thus the next to be captured
+    Piece piece = board.SquarePiece(ori);
+
+    // gain[i] is the material won by the side making the i'th capture, should the exchange end
+    // there, where at most every piece of the board takes part
+    std::array<int, 33> gain;
+    gain[0] = victim == PIECE_NONE ? 0 : SEE_VALUES[victim];
+    if (move.IsPromotion()) {
+        piece = move.PromotionPiece();
+        gain[0] += SEE_VALUES[piece] - SEE_VALUES[PAWN];
+    }
+
+    const BB bishops = board.Pieces(BISHOP) | board.Pieces(QUEEN);
+    const BB rooks   = board.Pieces(ROOK) | board.Pieces(QUEEN);
+    BB attackers     = board.AttackersTo(dst, occ) & occ;
+    Color side       = !us;
+    int depth        = 0;
+    while (true) {
+        const BB ours = attackers & board.Pieces(side);
+        if (!ours) break;
+
+        Piece attacker = PAWN;
+        while (!(ours & board.Pieces(attacker)))
+            attacker = static_cast<Piece>(attacker + 1);
+        // The king may only capture once the other side has nothing left to recapture with
+        if (attacker == KING && (attackers & board.Pieces(!side))) break;
+
+        depth++;
+        gain[depth] = SEE_VALUES[piece] - gain[depth - 1];
+        // The capture cannot improve upon standing pat, which it would be declined for, so it and
+        // all that follow are left out
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            depth--;
+            break;
+        }
+
+        // Removing the attacker may reveal a slider behind it
+        occ ^= lsb(ours & board.Pieces(attacker));
+        if (attacker == PAWN || attacker == BISHOP || attacker == QUEEN)
+            attackers |= BishopAttacks(dst, occ) & bishops;
+        if (attacker == ROOK || attacker == QUEEN) attackers |= RookAttacks(dst, occ) & rooks;
+        attackers &= occ;
+        piece = attacker;
+        side  = !side;
+    }
+
+    // Each side may decline to recapture, so the result is unwound from the last capture
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+} // namespace Chess
@@ -0,0 +1,52 @@
+#include <JankChess/tt.hpp>
+#include <algorithm>
+#include <bit>
+
+namespace Chess {
+// An entry is packed as move, score, depth, and bound from the lowest bits up
+uint64_t Pack(const TTEntry &entry) {
+    return std::bit_cast<uint16_t>(entry.move) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 16) |
+           (static_cast<uint64_t>(entry.depth) << 32) |
+           (static_cast<uint64_t>(entry.bound) << 40);
+}
+
+TTEntry Unpack(uint64_t data) {
+    return {
+        std::bit_cast<Move>(static_cast<uint16_t>(data)), static_cast<int16_t>(data >> 16),
+        static_cast<uint8_t>(data >> 32), static_cast<Bound>(data >> 40)
+    };
+}
+
+TranspositionTable::TranspositionTable(size_t mb)
+    : slots(std::bit_floor(std::max<size_t>(1, (mb << 20) / sizeof(Slot)))),
+      mask(slots.size() - 1) {
+    Clear();
+}
+
+std::optional<TTEntry> TranspositionTable::Probe(Hash hash) const noexcept {
+    const Slot &slot    = slots[hash & mask];
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) != hash) return std::nullopt;
+    const TTEntry entry = Unpack(data);
+    if (entry.bound == Bound::None) return std::nullopt;
+    return entry;
+}
+
+void TranspositionTable::Store(Hash hash, Move move, int score, int depth, Bound bound) noexcept {
+    if (move == Move())
+        if (const auto prior = Probe(hash)) move = prior->move;
+    Slot &slot = slots[hash & mask];
+    const uint64_t data =
+        Pack({move, static_cast<int16_t>(score), static_cast<uint8_t>(depth), bound});
+    slot.check.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear() noexcept {
+    for (auto &slot : slots) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    }
+}
+} // namespace Chess
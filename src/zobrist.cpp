@@ -2,30 +2,39 @@
 
 namespace Chess {
 
-// Generate hashses in a pseudo-random way
+// Generate hashses in a pseudo-random way, by SplitMix64
 // Cannot use *actual* randomness as its compile time
-// This is, however, good enough
+// This is, however, good enough, as opposed to e.g. an LFSR whose successive states are shifts
+// of one another
 constexpr std::array<uint64_t, HASH_COUNT> HASHES = [] {
     auto tempTable = decltype(HASHES){};
 
-    uint64_t lfsr = 0x181818ffff181818;
-    uint64_t bit;
+    uint64_t state = 0x181818ffff181818;
 
-    for (int i = 0; i < HASH_COUNT; i++) {
-        bit          = ((lfsr >> 0) ^ (lfsr >> 2) ^ (lfsr >> 3) ^ (lfsr >> 5)) & 1u;
-        lfsr         = (lfsr >> 1) | (bit << 63);
-        tempTable[i] = lfsr;
+    for (size_t i = 0; i < HASH_COUNT; i++) {
+        uint64_t z   = (state += 0x9e3779b97f4a7c15);
+        z            = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z            = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        tempTable[i] = z ^ (z >> 31);
     }
 
     return tempTable;
 }();
 
+constexpr size_t CASTLE_OFFSET = 1;
+constexpr size_t EP_OFFSET     = CASTLE_OFFSET + 4 * COLOR_COUNT;
+constexpr size_t SQUARE_OFFSET = EP_OFFSET + SQUARE_COUNT;
+
 Hash FlipTurn(Hash hash) { return hash ^ HASHES[0]; }
 Hash FlipCastle(Hash hash, Color color, Castling castling) {
-    return hash ^ HASHES[1 + color * static_cast<int>(castling)];
+    return hash ^ HASHES[CASTLE_OFFSET + 4 * color + static_cast<int>(castling)];
+}
+Hash FlipEnpassant(Hash hash, Square sq) {
+    if (sq == SQUARE_NONE) return hash;
+    return hash ^ HASHES[EP_OFFSET + sq];
 }
-Hash FlipEnpassant(Hash hash, Square sq) { return hash ^ HASHES[1 + 8 + sq]; }
 Hash FlipSquare(Hash hash, Color color, Piece piece_type, Square square) {
-    return hash ^ HASHES[1 + 8 + SQUARE_COUNT + color * static_cast<int>(piece_type) * square];
+    const size_t piece = color * PIECE_COUNT + piece_type;
+    return hash ^ HASHES[SQUARE_OFFSET + piece * SQUARE_COUNT + square];
 }
 } // namespace Chess
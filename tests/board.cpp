@@ -1,6 +1,7 @@
 #include "third_party/doctest.h"
 #include <JankChess/board.hpp>
 #include <JankChess/masks.hpp>
+#include <JankChess/move_gen.hpp>
 #include <JankChess/types.hpp>
 
 using namespace Chess;
@@ -191,7 +192,7 @@ TEST_SUITE("BOARD::UPDATE") {
         CHECK_EQ(board.GetHash(), prior_hash);
     }
     TEST_CASE("EP") {
-        Board board = Board("8/8/8/8/1p6/8/P7/8 w - - 0 1", "a2a4");
+        Board board = Board("4k3/8/8/8/1p6/8/P7/4K3 w - - 0 1", "a2a4");
 
         const Hash prior_hash = board.GetHash();
         CHECK_EQ(board.EP(), A3);
@@ -205,3 +206,232 @@ TEST_SUITE("BOARD::UPDATE") {
         CHECK_EQ(board.GetHash(), prior_hash);
     }
 }
+
+// Checks the attack maps of board against those generated from scratch
+static void CheckAttacks(const Board &board) {
+    for (const auto color : {WHITE, BLACK}) {
+        CHECK_EQ(board.Attacks(color), board.GenerateAttacks(color));
+        for (const auto sq : SQUARES)
+            CHECK_EQ(
+                board.AttackerCount(color, sq),
+                popcount(board.AttackersTo(sq) & board.Pieces(color))
+            );
+    }
+}
+
+TEST_SUITE("BOARD::ATTACKS") {
+    TEST_CASE("COUNTS") {
+        // d5 is attacked by both pawns and the knight of black, and by the pawn, knight and bishop
+        // of white
+        const Board board = Board("4k3/8/2p1pn2/8/4PN2/1B6/8/4K3 w - - 0 1");
+        CHECK_EQ(board.AttackerCount(BLACK, D5), 3);
+        CHECK_EQ(board.AttackerCount(WHITE, D5), 3);
+        CHECK_EQ(board.AttackerCount(WHITE, H8), 0);
+    }
+    TEST_CASE("INCREMENTAL") {
+        // Every move and its undo keeps the attacks equal to those generated, including sliders
+        // uncovered or blocked by castling, en passant and promotions
+        for (const auto FEN : {
+                 "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+                 "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+                 "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+             }) {
+            Board board = Board(FEN);
+            CheckAttacks(board);
+            for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+                board.ApplyMove(move);
+                CheckAttacks(board);
+                for (const auto reply : GenerateMovesLegal(board, board.Turn())) {
+                    board.ApplyMove(reply);
+                    CheckAttacks(board);
+                    board.UndoMove(reply);
+                }
+                board.UndoMove(move);
+            }
+            CheckAttacks(board);
+        }
+    }
+}
+
+TEST_SUITE("BOARD::FEN") {
+    TEST_CASE("EXPORT") {
+        for (const auto FEN : {
+                 "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                 "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                 "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1",
+                 "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 37 82",
+             })
+            CHECK_EQ(Board(FEN).ExportFEN(), FEN);
+        // Missing clocks are those of a new game
+        CHECK_EQ(Board("8/8/8/8/8/8/8/K6k w - - ").ExportFEN(), "8/8/8/8/8/8/8/K6k w - - 0 1");
+    }
+    TEST_CASE("EXPORT_BUFFER") {
+        const Board board =
+            Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+        char buffer[FEN_MAX_LENGTH];
+        const size_t length = board.ExportFEN(buffer);
+        CHECK_EQ(std::string(buffer), board.ExportFEN());
+        CHECK_EQ(length, board.ExportFEN().size());
+    }
+    TEST_CASE("PARSE") {
+        // A parsed board is equal to one constructed, even when reused
+        Board board = Board("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 37 82");
+        const std::string_view FEN =
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+        const FENResult result = board.ParseFEN(FEN);
+        CHECK_EQ(result.error, FENError::None);
+        CHECK_EQ(result.offset, FEN.size());
+        CHECK_EQ(board.ExportFEN(), FEN);
+        CHECK_EQ(board.GetHash(), Board(FEN).GetHash());
+        CHECK_EQ(board.GetPSQT(), Board(FEN).GetPSQT());
+        CHECK_EQ(board.Ply(), 0);
+    }
+    TEST_CASE("PARSE_EPD") {
+        // The operations of an EPD line are left to the caller
+        Board board;
+        const std::string_view EPD = "4k3/8/8/3pP3/8/8/8/4K3 w - d6 bm exd6; id \"ep\";";
+        const FENResult result     = board.ParseFEN(EPD);
+        CHECK_EQ(result.error, FENError::None);
+        CHECK_EQ(EPD.substr(result.offset), " bm exd6; id \"ep\";");
+        CHECK_EQ(board.EP(), D6);
+        CHECK_EQ(board.HalfmoveClock(), 0);
+    }
+    TEST_CASE("PARSE_ERRORS") {
+        Board board;
+        const auto check = [&](std::string_view FEN, FENError error, size_t offset) {
+            const FENResult result = board.ParseFEN(FEN);
+            CHECK_EQ(result.error, error);
+            CHECK_EQ(result.offset, offset);
+        };
+        check("", FENError::Pieces, 0);
+        check("4k3/8/8/8/8/8/8/4K3", FENError::Turn, 19);
+        check("4k3/8/8/8/8/8/8/4K4 w - -", FENError::Pieces, 18);
+        check("4k3/8/8/8/8/8/8/4K2 w - -", FENError::Pieces, 19);
+        check("4k3/8/8/8/8/8/4K3 w - -", FENError::Pieces, 17);
+        check("4k3/8/8/8/8/8/8/4X3 w - -", FENError::Pieces, 17);
+        check("4k3/8/8/8/8/8/8/4K3 x - -", FENError::Turn, 20);
+        check("4k3/8/8/8/8/8/8/4K2R w KX -", FENError::Castling, 24);
+        // Each side must have a single king
+        check("8/8/8/8/8/8/8/8 w - - 0 1", FENError::Pieces, 15);
+        check("4k3/8/8/8/8/8/8/4KK2 w - -", FENError::Pieces, 20);
+        // Castling requires the king and rook on their original squares
+        check("4k3/8/8/8/8/8/8/4K3 w K -", FENError::Castling, 22);
+        check("4k2r/8/8/8/8/8/8/4K3 w q -", FENError::Castling, 23);
+        check("r6k/8/8/8/8/8/8/4K3 w q -", FENError::Castling, 22);
+        check("4k3/8/8/8/8/8/8/4K3 w - e3", FENError::EP, 24);
+        check("4k3/8/8/8/8/8/8/4K3 w -", FENError::EP, 23);
+        check("4k3/8/8/8/8/8/8/4K3 w - - 5", FENError::Clocks, 27);
+        check("4k3/8/8/8/8/8/8/4K3 w - - 5 x", FENError::Clocks, 28);
+        CHECK_EQ(std::string(FENErrorName(FENError::Castling)), "castling");
+    }
+    TEST_CASE("CLOCKS") {
+        Board board = Board("4k3/8/8/8/8/8/4P3/4K1N1 w - - 12 30");
+        CHECK_EQ(board.HalfmoveClock(), 12);
+        board.ApplyMove(Move(G1, F3, Move::Quiet));
+        CHECK_EQ(board.HalfmoveClock(), 13);
+        CHECK_EQ(board.ExportFEN(), "4k3/8/8/8/8/5N2/4P3/4K3 b - - 13 30");
+        board.ApplyMove(Move(E8, D8, Move::Quiet));
+        CHECK_EQ(board.ExportFEN(), "3k4/8/8/8/8/5N2/4P3/4K3 w - - 14 31");
+        // Pawn moves reset the clock, which undoing restores
+        board.ApplyMove(Move(E2, E4, Move::DoublePawnPush));
+        CHECK_EQ(board.ExportFEN(), "3k4/8/8/8/4P3/5N2/8/4K3 b - e3 0 31");
+        board.UndoMove(Move(E2, E4, Move::DoublePawnPush));
+        CHECK_EQ(board.HalfmoveClock(), 14);
+    }
+}
+
+TEST_SUITE("BOARD::DRAWS") {
+    TEST_CASE("REPETITION") {
+        Board board = Board();
+        const Move moves[] = {
+            Move(G1, F3, Move::Quiet), Move(G8, F6, Move::Quiet),
+            Move(F3, G1, Move::Quiet), Move(F6, G8, Move::Quiet),
+        };
+        for (const auto move : moves) {
+            CHECK_FALSE(board.IsRepetition());
+            board.ApplyMove(move);
+        }
+        CHECK(board.IsRepetition());
+        board.UndoMove(moves[3]);
+        CHECK_FALSE(board.IsRepetition());
+    }
+    TEST_CASE("IRREVERSIBLE") {
+        // The knights return after a pawn move, which cannot be undone, so the position before it
+        // is not repeated
+        Board board =
+            Board("4k1n1/4p3/8/8/8/8/4P3/4K1N1 w - - 0 1", "g1f3 g8f6 e2e3 f6g8 f3g1 g8f6");
+        CHECK_FALSE(board.IsRepetition());
+        board.ApplyMove(Move(G1, F3, Move::Quiet));
+        board.ApplyMove(Move(F6, G8, Move::Quiet));
+        CHECK(board.IsRepetition());
+    }
+    TEST_CASE("FIFTY_MOVES") {
+        Board board = Board("4k3/8/8/8/8/8/8/4K1N1 w - - 99 80");
+        CHECK_FALSE(board.IsFiftyMoveDraw());
+        board.ApplyMove(Move(G1, F3, Move::Quiet));
+        CHECK(board.IsFiftyMoveDraw());
+    }
+}
+
+TEST_SUITE("BOARD::HISTORY") {
+    TEST_CASE("LONG_GAME") {
+        // Far more moves than are kept, where only the most recent may be undone
+        std::string moves;
+        for (int i = 0; i < 150; i++)
+            moves += "g1f3 g8f6 f3g1 f6g8 ";
+        Board board = Board(Board().ExportFEN(), moves);
+        CHECK_EQ(board.Ply(), 600);
+        CHECK_EQ(board.GetHash(), Board().GetHash());
+        CHECK(board.IsRepetition());
+        CHECK(board.IsFiftyMoveDraw());
+        CHECK_EQ(board.ExportFEN(), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 600 301");
+
+        board.ApplyMove(Move(E2, E4, Move::DoublePawnPush));
+        CHECK_FALSE(board.IsRepetition());
+        const Move shuffle[] = {
+            Move(G8, F6, Move::Quiet), Move(G1, F3, Move::Quiet),
+            Move(F6, G8, Move::Quiet), Move(F3, G1, Move::Quiet),
+        };
+        for (int i = 0; i < MAX_PLY / 4 - 1; i++)
+            for (const auto move : shuffle)
+                board.ApplyMove(move);
+        for (int i = 0; i < MAX_PLY / 4 - 1; i++)
+            for (int j = 3; j >= 0; j--)
+                board.UndoMove(shuffle[j]);
+        CHECK_EQ(board.EP(), E3);
+        CHECK_EQ(board.HalfmoveClock(), 0);
+        CHECK_EQ(board.GetHash(), board.ComputeHashFromScratch());
+    }
+    TEST_CASE("ATTACHED") {
+        // The positions of the game are known only through the history, as the board is created
+        // from the position reached after them
+        const Move moves[] = {
+            Move(G1, F3, Move::Quiet), Move(G8, F6, Move::Quiet),
+            Move(F3, G1, Move::Quiet), Move(F6, G8, Move::Quiet),
+        };
+        GameHistory history;
+        Board game = Board();
+        for (const auto move : moves) {
+            history.push_back(game.GetHash());
+            game.ApplyMove(move);
+        }
+
+        Board board = Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 4 3");
+        CHECK_FALSE(board.IsRepetition());
+        board.AttachHistory(&history);
+        CHECK(board.IsRepetition());
+
+        // Each position repeats one of the history, until the board has kept those it repeats
+        for (const auto move : moves) {
+            board.ApplyMove(move);
+            CHECK(board.IsRepetition());
+        }
+
+        // Copies share the history
+        const Board copy = board;
+        CHECK(copy.IsRepetition());
+
+        board.ApplyMove(Move(E2, E4, Move::DoublePawnPush));
+        CHECK_FALSE(board.IsRepetition());
+    }
+}
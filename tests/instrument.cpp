@@ -0,0 +1,45 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/instrument.hpp>
+#include <JankChess/move_gen.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Chess;
+
+TEST_CASE("INSTRUMENT::COUNTERS") {
+    Board board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    [[maybe_unused]] const Counters before = CounterTotals();
+    const MoveList moves                   = GenerateMovesAll(board, board.Turn());
+    board.ApplyMove(moves[0]);
+    board.UndoMove(moves[0]);
+    const Counters after = CounterTotals();
+
+#ifdef JANKCHESS_STATS
+    CHECK_EQ(after[COUNTER_MOVES_CASTLE] - before[COUNTER_MOVES_CASTLE], 2);
+    CHECK_EQ(after[COUNTER_MOVES_CAPTURE] - before[COUNTER_MOVES_CAPTURE], 2);
+    CHECK_EQ(after[COUNTER_MOVES_QUIET] - before[COUNTER_MOVES_QUIET], moves.size() - 4);
+    CHECK_EQ(after[COUNTER_CASTLING_ATTACKS] - before[COUNTER_CASTLING_ATTACKS], 1);
+    CHECK_EQ(after[COUNTER_MOVES_APPLIED] - before[COUNTER_MOVES_APPLIED], 1);
+#else
+    // Nothing is counted unless enabled
+    for (size_t i = 0; i < COUNTER_COUNT; i++)
+        CHECK_EQ(after[i], 0);
+#endif
+}
+
+TEST_CASE("INSTRUMENT::TRACE") {
+    const Board board;
+    GenerateMovesAll(board, board.Turn());
+
+    const char *path = "instrument_trace.json";
+    CHECK_EQ(WriteTrace(path), TRACE_ENABLED);
+#ifdef JANKCHESS_TRACE
+    std::stringstream trace;
+    trace << std::ifstream(path).rdbuf();
+    CHECK_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+    CHECK_NE(trace.str().find("\"name\": \"GenerateMovesAll\""), std::string::npos);
+    std::remove(path);
+#endif
+}
@@ -119,3 +119,50 @@ TEST_CASE("BITBOARD::QueenAttacks") {
     CHECK_EQ(PSEUDO_ATTACKS[QUEEN][A8], 0xfe03050911214181);
     CHECK_EQ(PSEUDO_ATTACKS[QUEEN][H8], 0x7fc0a09088848281);
 }
+
+TEST_CASE("BITBOARD::SliderAttacksEmpty") {
+    for (const auto sq : SQUARES) {
+        CHECK_EQ(BishopAttacks(sq, 0), PSEUDO_ATTACKS[BISHOP][sq]);
+        CHECK_EQ(RookAttacks(sq, 0), PSEUDO_ATTACKS[ROOK][sq]);
+    }
+}
+
+TEST_CASE("BITBOARD::SliderAttacksBlocked") {
+    const BB occ = ToBB(D6) | ToBB(B4) | ToBB(F2) | ToBB(G7) | ToBB(D1);
+    CHECK_EQ(RookAttacks(D4, occ), 0x808f6080808);
+    CHECK_EQ(BishopAttacks(D4, occ), 0x41221400142201);
+    CHECK_EQ(RookAttacks(A1, ToBB(A2) | ToBB(B1)), 0x102);
+    CHECK_EQ(BishopAttacks(H8, ToBB(G7)), 0x40000000000000);
+}
+
+TEST_CASE("BITBOARD::SliderBackends") {
+    const SliderBackend initial = SLIDER_BACKEND;
+    const BB occ                = ToBB(D6) | ToBB(B4) | ToBB(F2) | ToBB(G7) | ToBB(D1);
+    for (const auto backend : {SliderBackend::Magic, SliderBackend::Pext}) {
+        if (!SetSliderBackend(backend)) continue;
+        CHECK_EQ(SLIDER_BACKEND, backend);
+        CHECK_EQ(RookAttacks(D4, occ), 0x808f6080808);
+        CHECK_EQ(BishopAttacks(D4, occ), 0x41221400142201);
+        for (const auto sq : SQUARES) {
+            CHECK_EQ(BishopAttacks(sq, 0), PSEUDO_ATTACKS[BISHOP][sq]);
+            CHECK_EQ(RookAttacks(sq, 0), PSEUDO_ATTACKS[ROOK][sq]);
+        }
+    }
+    CHECK(SetSliderBackend(initial));
+#ifdef JANKCHESS_NATIVE
+    // Lookups are compiled for a single backend
+    const SliderBackend other =
+        initial == SliderBackend::Magic ? SliderBackend::Pext : SliderBackend::Magic;
+    CHECK_FALSE(SetSliderBackend(other));
+#endif
+}
+
+TEST_CASE("BITBOARD::Between") {
+    CHECK_EQ(BETWEEN[A1][H8], 0x40201008040200);
+    CHECK_EQ(BETWEEN[H8][A1], 0x40201008040200);
+    CHECK_EQ(BETWEEN[A1][A8], 0x1010101010100);
+    CHECK_EQ(BETWEEN[E1][H1], 0x60);
+    CHECK_EQ(BETWEEN[E1][F2], 0);
+    CHECK_EQ(BETWEEN[E1][F3], 0);
+    CHECK_EQ(BETWEEN[E1][B8], 0);
+}
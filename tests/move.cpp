@@ -1,4 +1,5 @@
 #include "third_party/doctest.h"
+#include <JankChess/board.hpp>
 #include <JankChess/move.hpp>
 #include <JankChess/types.hpp>
 
@@ -172,3 +173,14 @@ TEST_CASE("MOVE::PROMOTIONPIECE") {
     CHECK_EQ(Move(A1, A8, Move::RPromotionCapture).PromotionPiece(), ROOK);
     CHECK_EQ(Move(A1, A8, Move::QPromotionCapture).PromotionPiece(), QUEEN);
 }
+
+TEST_CASE("MOVE::PARSE_DOUBLE_PUSH") {
+    const Board board = Board();
+    const BB occ      = board.Pieces();
+    const BB kings    = board.Pieces(KING);
+    const BB pawns    = board.Pieces(PAWN);
+    CHECK_EQ(Move(occ, kings, pawns, "e2e4"), Move(E2, E4, Move::DoublePawnPush));
+    CHECK_EQ(Move(occ, kings, pawns, "e7e5"), Move(E7, E5, Move::DoublePawnPush));
+    const std::string FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    CHECK_EQ(Board(FEN, "e2e4 e7e5").EP(), E6);
+}
@@ -2,6 +2,7 @@
 #include <JankChess/move.hpp>
 #include <JankChess/move_gen.hpp>
 #include <JankChess/types.hpp>
+#include <algorithm>
 
 using namespace Chess;
 
@@ -32,4 +33,114 @@ TEST_SUITE("MOVE_GEN") {
         MoveList moves = GenerateMovesAll(board, WHITE);
         CHECK(moves.contains(Move(H4, G5, Move::Capture)));
     }
+    TEST_CASE("LEGAL::PIN") {
+        // The bishop on d2 is pinned by the queen on a5 and can only capture it, or block on c3/b4
+        Board board    = Board("4k3/8/8/q7/8/8/3B4/4K3 w - - 0 1");
+        MoveList moves = GenerateMovesLegal(board, WHITE);
+        CHECK(moves.contains(Move(D2, A5, Move::Capture)));
+        CHECK(moves.contains(Move(D2, B4, Move::Quiet)));
+        CHECK(moves.contains(Move(D2, C3, Move::Quiet)));
+        CHECK_FALSE(moves.contains(Move(D2, E3, Move::Quiet)));
+        CHECK_FALSE(moves.contains(Move(D2, C1, Move::Quiet)));
+    }
+    TEST_CASE("LEGAL::DOUBLE_CHECK") {
+        Board board    = Board("4k3/8/8/8/8/5n2/8/R3K2r w Q - 0 1");
+        MoveList moves = GenerateMovesLegal(board, WHITE);
+        for (const auto move : moves)
+            CHECK_EQ(move.Origin(), E1);
+        CHECK_EQ(moves.size(), 2);
+    }
+    TEST_CASE("LEGAL::EP_DISCOVERED_CHECK") {
+        // Capturing en passant removes both pawns from the fourth rank, exposing the king to the rook
+        Board board    = Board("4K3/8/8/8/R2p3k/8/4P3/8 w - - 0 1", "e2e4");
+        MoveList moves = GenerateMovesLegal(board, BLACK);
+        CHECK_EQ(board.EP(), E3);
+        CHECK_FALSE(moves.contains(Move(D4, E3, Move::EPCapture)));
+        CHECK(moves.contains(Move(D4, D3, Move::Quiet)));
+    }
+    TEST_CASE("LEGAL::EP_RESOLVES_CHECK") {
+        // The double pushed pawn gives check, which capturing it en passant resolves
+        Board board    = Board("8/8/8/4k3/4p3/8/3P4/4K3 w - - 0 1", "d2d4");
+        MoveList moves = GenerateMovesLegal(board, BLACK);
+        CHECK(moves.contains(Move(E4, D3, Move::EPCapture)));
+        CHECK_FALSE(moves.contains(Move(E4, E3, Move::Quiet)));
+    }
+    TEST_CASE("LEGAL::MATCHES_PSEUDO_LEGAL") {
+        const std::string fens[] = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        };
+        // Compares the legal generator and counter against filtering pseudo-legal moves, two plies
+        // deep
+        const auto compare = [](Board &board) {
+            MoveList legal  = GenerateMovesLegal(board, board.Turn());
+            MoveList pseudo = GenerateMovesAll(board, board.Turn());
+            size_t count    = 0;
+            for (const auto move : pseudo) {
+                board.ApplyMove(move);
+                if (board.IsKingSafe(!board.Turn())) {
+                    CHECK(legal.contains(move));
+                    count++;
+                }
+                board.UndoMove(move);
+            }
+            CHECK_EQ(legal.size(), count);
+            CHECK_EQ(CountMovesLegal(board, board.Turn()), count);
+            return legal;
+        };
+        for (const auto &fen : fens) {
+            Board board = Board(fen);
+            for (const auto move : compare(board)) {
+                board.ApplyMove(move);
+                compare(board);
+                board.UndoMove(move);
+            }
+        }
+    }
+    TEST_CASE("VISIT::COUNT") {
+        // Counting moves by groups must agree with the generated list and the bulk counter
+        Board board = Board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+        struct Counter {
+            size_t count = 0;
+            bool operator()(Move) {
+                count++;
+                return true;
+            }
+            bool operator()(Square, BB targets, Move::Type) {
+                count += popcount(targets);
+                return true;
+            }
+        } counter;
+        CHECK(VisitMovesLegal(board, WHITE, counter));
+        CHECK_EQ(counter.count, GenerateMovesLegal(board, WHITE).size());
+        CHECK_EQ(counter.count, CountMovesLegal(board, WHITE));
+    }
+    TEST_CASE("VISIT::EARLY_EXIT") {
+        Board board          = Board();
+        const MoveList moves = GenerateMovesAll(board, WHITE);
+        MoveList visited;
+        const bool finished = VisitMovesAll(board, WHITE, [&](Move move) {
+            visited << move;
+            return visited.size() < 3;
+        });
+        CHECK_FALSE(finished);
+        REQUIRE_EQ(visited.size(), 3);
+        for (size_t i = 0; i < visited.size(); i++)
+            CHECK_EQ(visited[i], moves[i]);
+    }
+    TEST_CASE("PSEUDO_LEGAL") {
+        Board board    = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+        MoveList moves = GenerateMovesAll(board, WHITE);
+        for (const auto move : moves)
+            CHECK(IsPseudoLegal(board, move));
+        // Those of black, or wrongly typed, are not
+        for (const auto move : GenerateMovesAll(board, BLACK))
+            CHECK_FALSE(IsPseudoLegal(board, move));
+        CHECK_FALSE(IsPseudoLegal(board, Move(D5, D6, Move::Capture)));
+        CHECK_FALSE(IsPseudoLegal(board, Move(A2, A4, Move::Quiet)));
+        CHECK_FALSE(IsPseudoLegal(board, Move(E5, F7, Move::Quiet)));
+    }
 }
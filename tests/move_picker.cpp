@@ -0,0 +1,51 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/move_picker.hpp>
+#include <JankChess/types.hpp>
+
+using namespace Chess;
+
+// Returns the moves yielded by the picker in order
+MoveList PickAll(MovePicker picker) {
+    MoveList moves;
+    for (Move move = picker.Next(); !(move == Move()); move = picker.Next())
+        moves << move;
+    return moves;
+}
+
+TEST_SUITE("MOVE_PICKER") {
+    TEST_CASE("MATCHES_GENERATOR") {
+        Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+
+        const MoveList all    = GenerateMovesAll(board, WHITE);
+        const Move hash_move  = Move(E1, G1, Move::KingCastle);
+        const Move killers[2] = {Move(A2, A3, Move::Quiet), Move(D5, D6, Move::Quiet)};
+        const MoveList picked = PickAll(MovePicker(board, hash_move, {killers[0], killers[1]}));
+        CHECK_EQ(picked.size(), all.size());
+        for (const auto move : all)
+            CHECK(picked.contains(move));
+        CHECK_EQ(picked[0], hash_move);
+    }
+    TEST_CASE("ORDER") {
+        // The queen on d5 may be captured by the pawn and the rook, the knight on g5 by the rook
+        Board board           = Board("4k3/8/8/3q2n1/4P3/8/8/3RK3 w - - 0 1");
+        const Move killer     = Move(E1, F2, Move::Quiet);
+        const MoveList picked = PickAll(MovePicker(board, Move(), {killer, Move()}));
+        REQUIRE_GE(picked.size(), 4);
+        CHECK_EQ(picked[0], Move(E4, D5, Move::Capture));
+        CHECK_EQ(picked[1], Move(D1, D5, Move::Capture));
+        CHECK_EQ(picked[2], killer);
+        CHECK_FALSE(picked[3].IsCapture());
+    }
+    TEST_CASE("INVALID_HINTS") {
+        // Neither the hash move nor the killer is possible, so neither may be yielded
+        Board board           = Board();
+        const Move hash_move  = Move(E4, E5, Move::Quiet);
+        const Move killer     = Move(F1, C4, Move::Quiet);
+        const MoveList picked = PickAll(MovePicker(board, hash_move, {killer, killer}));
+        CHECK_EQ(picked.size(), 20);
+        CHECK_FALSE(picked.contains(hash_move));
+        CHECK_FALSE(picked.contains(killer));
+    }
+}
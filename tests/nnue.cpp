@@ -0,0 +1,147 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/eval.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/nnue.hpp>
+#include <JankChess/search.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace Chess;
+
+// A network of small random weights, which is meaningless but exercises every weight
+std::shared_ptr<Network> RandomNetwork(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-64, 64);
+    auto network = std::make_shared<Network>();
+    for (auto &row : network->feature_weights)
+        for (auto &weight : row)
+            weight = dist(rng);
+    for (auto &bias : network->feature_bias)
+        bias = dist(rng);
+    for (auto &weight : network->output_weights)
+        weight = dist(rng);
+    network->output_bias = dist(rng);
+    return network;
+}
+
+// Evaluates the position of board without the accumulators or kernels
+int EvaluateNaive(const Network &network, const Board &board) {
+    int64_t output = network.output_bias * NNUE_QA;
+    for (const auto perspective : {board.Turn(), !board.Turn()}) {
+        const size_t offset = perspective == board.Turn() ? 0 : NNUE_HIDDEN;
+        for (size_t i = 0; i < NNUE_HIDDEN; i++) {
+            int value = network.feature_bias[i];
+            for (const auto sq : SQUARES) {
+                if (board.SquarePiece(sq) == PIECE_NONE) continue;
+                const Color color     = board.SquareColor(sq);
+                const size_t relative = static_cast<size_t>(sq) ^ (perspective == WHITE ? 0 : 56);
+                const size_t feature =
+                    ((color != perspective) * PIECE_COUNT + board.SquarePiece(sq)) * SQUARE_COUNT +
+                    relative;
+                value += network.feature_weights[feature][i];
+            }
+            output += std::clamp(value, 0, NNUE_QA) * network.output_weights[offset + i];
+        }
+    }
+    return output * NNUE_SCALE / (NNUE_QA * NNUE_QB);
+}
+
+TEST_CASE("NNUE_INCREMENTAL") {
+    // Every move keeps the accumulator equal to the one from scratch, and undoing it returns to
+    // the prior, which is left untouched
+    const auto network = RandomNetwork(1);
+    AccumulatorStack stack(network), scratch(network);
+    Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    board.AttachAccumulators(&stack);
+    const Accumulator root = stack[board.Ply()];
+    for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+        board.ApplyMove(move);
+        scratch.Refresh(board, board.Ply());
+        CHECK(stack[board.Ply()].values == scratch[board.Ply()].values);
+        for (const auto reply : GenerateMovesLegal(board, board.Turn())) {
+            board.ApplyMove(reply);
+            scratch.Refresh(board, board.Ply());
+            CHECK(stack[board.Ply()].values == scratch[board.Ply()].values);
+            board.UndoMove(reply);
+        }
+        board.UndoMove(move);
+        CHECK(stack[board.Ply()].values == root.values);
+    }
+}
+
+TEST_CASE("NNUE_EVALUATE") {
+    const auto network = RandomNetwork(2);
+    AccumulatorStack stack(network);
+    for (const auto FEN : {
+             "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+             "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - ",
+             "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ",
+         }) {
+        Board board = Board(FEN);
+        board.AttachAccumulators(&stack);
+        CHECK_EQ(stack.Evaluate(board.Ply(), board.Turn()), EvaluateNaive(*network, board));
+    }
+}
+
+TEST_CASE("NNUE_SYMMETRIC") {
+    // Both perspectives share weights, so swapping colors, and mirroring the board, is equal
+    const auto network = RandomNetwork(3);
+    AccumulatorStack a_stack(network), b_stack(network);
+    Board a = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    Board b = Board("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - ");
+    a.AttachAccumulators(&a_stack);
+    b.AttachAccumulators(&b_stack);
+    CHECK_EQ(Evaluate(a), Evaluate(b));
+}
+
+TEST_CASE("NNUE_LOAD") {
+    const auto network = RandomNetwork(4);
+    const auto path    = std::filesystem::temp_directory_path() / "jankchess_nnue_test.bin";
+    const auto write   = [&](size_t count) {
+        std::ofstream file(path, std::ios::binary);
+        const auto put = [&](int16_t value) {
+            if (count == 0) return;
+            count--;
+            file.put(static_cast<char>(value & 0xff));
+            file.put(static_cast<char>((value >> 8) & 0xff));
+        };
+        for (const auto &row : network->feature_weights)
+            for (const auto weight : row)
+                put(weight);
+        for (const auto bias : network->feature_bias)
+            put(bias);
+        for (const auto weight : network->output_weights)
+            put(weight);
+        put(network->output_bias);
+    };
+
+    write(SIZE_MAX);
+    const auto loaded = Network::Load(path.string());
+    REQUIRE(loaded != nullptr);
+    CHECK(loaded->feature_weights == network->feature_weights);
+    CHECK(loaded->feature_bias == network->feature_bias);
+    CHECK(loaded->output_weights == network->output_weights);
+    CHECK_EQ(loaded->output_bias, network->output_bias);
+
+    // A truncated file is rejected rather than partially loaded
+    write(1000);
+    CHECK_EQ(Network::Load(path.string()), nullptr);
+    std::filesystem::remove(path);
+    CHECK_EQ(Network::Load(path.string()), nullptr);
+}
+
+TEST_CASE("NNUE_SEARCH") {
+    Searcher searcher(1, 2);
+    searcher.SetNetwork(RandomNetwork(5));
+    const Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    SearchLimits limits;
+    limits.depth              = 4;
+    const SearchResult result = searcher.Search(board, limits);
+    CHECK_EQ(result.depth, 4);
+    CHECK(GenerateMovesLegal(board, WHITE).contains(result.best_move));
+    // The caller's board is never attached to the searcher's accumulators
+    CHECK_EQ(board.GetAccumulators(), nullptr);
+}
@@ -0,0 +1,26 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/perf_counters.hpp>
+
+using namespace Chess;
+
+TEST_CASE("PERF_COUNTERS") {
+    PerfCounters counters;
+    Board board;
+    counters.Start();
+    const MoveList moves    = GenerateMovesLegal(board, board.Turn());
+    const PerfCounts counts = counters.Stop();
+    CHECK_EQ(moves.size(), 20);
+
+#ifdef JANKCHESS_PERF_COUNTERS
+    // The host, or its permissions, may not allow any event to be counted
+    if (!counters.Available()) return;
+    if (counts.valid[PERF_INSTRUCTIONS]) CHECK_GT(counts.counts[PERF_INSTRUCTIONS], 0);
+#else
+    // Nothing is counted unless enabled
+    CHECK_FALSE(counters.Available());
+    for (const bool valid : counts.valid)
+        CHECK_FALSE(valid);
+#endif
+}
@@ -1,82 +1,68 @@
 #include "third_party/doctest.h"
 #include <JankChess/board.hpp>
-#include <JankChess/move_gen.hpp>
+#include <JankChess/perft.hpp>
+#include <JankChess/position.hpp>
 #include <chrono>
+#include <vector>
 
 using namespace Chess;
 
-size_t Perft(Board &board, int depth) {
-    if (depth == 0) return 1;
-    MoveList moves;
-    GenerateMovesAll(moves, board, board.Turn());
-
-    size_t nodes = 0;
-
-    for (const auto &move : moves) {
-        board.ApplyMove(move);
-        if (board.IsKingSafe(!board.Turn())) nodes += Perft(board, depth - 1);
-        board.UndoMove(move);
-    }
-
-    return nodes;
-}
-
 struct Instance {
     std::string FEN;
     size_t depth;
     size_t nodes;
 };
 
-TEST_CASE("PERFT") {
-    const Instance instances[] = {
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1, 20},
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 2, 400},
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8'902},
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197'281},
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4'865'609},
-        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119'060'324},
-        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 1, 48},
-        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 2, 2'039},
-        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 3, 97'862},
-        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 4, 4'085'603},
-        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 5, 193'690'690},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 1, 14},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 2, 191},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 3, 2'812},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 4, 43'238},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 5, 674'624},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 6, 11'030'083},
-        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 7, 178'633'661},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 1, 6},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 2, 264},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9'467},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422'333},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15'833'292},
-        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 6, 706'045'033},
-        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 1, 44},
-        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2, 1'486},
-        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62'379},
-        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2'103'487},
-        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89'941'194},
-        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 1, 46},
-        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 2, 2'079},
-        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 3, 89'890},
-        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 4, 3'894'594},
-        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 5, 164'075'551},
-        {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 1, 47},
-        {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 2, 1'079},
-        {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 3, 45'764},
-        {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 4, 1'125'017},
-        {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 5, 44'681'668},
-        {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 1, 39},
-        {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 2, 990},
-        {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 3, 32947},
-        {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 4, 950479},
-        {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 5, 31197407},
-    };
+const Instance INSTANCES[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 1, 20},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 2, 400},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8'902},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197'281},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4'865'609},
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119'060'324},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 1, 48},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 2, 2'039},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 3, 97'862},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 4, 4'085'603},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ", 5, 193'690'690},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 1, 14},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 2, 191},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 3, 2'812},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 4, 43'238},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 5, 674'624},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 6, 11'030'083},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ", 7, 178'633'661},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 1, 6},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 2, 264},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9'467},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422'333},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15'833'292},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 6, 706'045'033},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 1, 44},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2, 1'486},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62'379},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2'103'487},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89'941'194},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 1, 46},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 2, 2'079},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 3, 89'890},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 4, 3'894'594},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 1", 5, 164'075'551},
+    {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 1, 47},
+    {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 2, 1'079},
+    {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 3, 45'764},
+    {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 4, 1'125'017},
+    {"r4k2/pp2p3/1n3b1p/5QnP/8/2N5/PPP3P1/4R2K w - - 2 24", 5, 44'681'668},
+    {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 1, 39},
+    {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 2, 990},
+    {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 3, 32947},
+    {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 4, 950479},
+    {"3rB2k/3PQRbp/6p1/1p1q1p2/7P/6P1/P4P1K/8 b - - 10 39", 5, 31197407},
+};
 
+TEST_CASE("PERFT") {
     static Board board;
-    for (const auto instance : instances) {
+    for (const auto &instance : INSTANCES) {
         board = Board(instance.FEN);
 
         const auto t1     = std::chrono::high_resolution_clock::now();
@@ -92,3 +78,93 @@ TEST_CASE("PERFT") {
         CHECK_EQ(nodes, instance.nodes);
     }
 }
+
+// The alternate modes share move generation with PERFT, so are only verified upon the cheaper
+// instances, rather than counting the deepest trees again
+constexpr size_t ALTERNATE_MAX_NODES = 50'000'000;
+
+TEST_CASE("PERFT_BULK") {
+    static Board board;
+    for (const auto &instance : INSTANCES) {
+        if (instance.nodes > ALTERNATE_MAX_NODES) continue;
+        board = Board(instance.FEN);
+        CHECK_EQ(PerftBulk(board, instance.depth), instance.nodes);
+    }
+}
+
+TEST_CASE("PERFT_COPY") {
+    for (const auto &instance : INSTANCES) {
+        if (instance.nodes > ALTERNATE_MAX_NODES) continue;
+        CHECK_EQ(PerftCopy(Position(instance.FEN), instance.depth, true), instance.nodes);
+    }
+}
+
+// The parallel divide is verified upon the cheaper instances, at every thread count and split depth
+// against the single threaded divide
+constexpr size_t PARALLEL_MAX_NODES = 1'000'000;
+
+TEST_CASE("PERFT_PARALLEL") {
+    for (const auto &instance : INSTANCES) {
+        if (instance.nodes > PARALLEL_MAX_NODES) continue;
+        Board board          = Board(instance.FEN);
+        const int depth      = static_cast<int>(instance.depth);
+        const MoveList moves = GenerateMovesLegal(board, board.Turn());
+        std::vector<size_t> expected;
+        for (const auto move : moves) {
+            board.ApplyMove(move);
+            expected.push_back(PerftBulk(board, depth - 1));
+            board.UndoMove(move);
+        }
+
+        for (const size_t threads : {1, 2, 8})
+            for (int split = 1; split <= 3; split++)
+                CHECK_EQ(PerftParallel(board, moves, depth, true, false, threads, split), expected);
+    }
+}
+
+TEST_CASE("PERFT_CACHE") {
+    // Small enough that distinct positions collide
+    PerftCache cache(1024);
+    const size_t size = cache.Size();
+    CHECK_EQ(size, 64);
+
+    const Hash hash = 0x123456789abcdef0;
+    CHECK_FALSE(cache.Probe(hash, 3));
+    cache.Store(hash, 3, 97'862);
+    CHECK_EQ(cache.Probe(hash, 3), 97'862);
+    // The depth is part of the key
+    CHECK_FALSE(cache.Probe(hash, 4));
+    // As is the hash, rather than just the entry it maps to
+    CHECK_FALSE(cache.Probe(hash + size, 3));
+    cache.Store(hash + size, 3, 2'039);
+    CHECK_EQ(cache.Probe(hash + size, 3), 2'039);
+    CHECK_FALSE(cache.Probe(hash, 3));
+    // Subtrees a ply deep are never cached
+    cache.Store(hash, 1, 48);
+    CHECK_FALSE(cache.Probe(hash, 1));
+}
+
+// Kiwipete at depth 5 through a cache small enough that entries are constantly replaced
+TEST_CASE("PERFT_CACHED") {
+    const std::string FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ";
+    const size_t nodes    = 193'690'690;
+    PerftCache cache(1024);
+    Board board = Board(FEN);
+    CHECK_EQ(Perft(board, 5, cache), nodes);
+    CHECK_EQ(PerftBulk(board, 5, cache), nodes);
+    CHECK_EQ(PerftCopy(Position(board), 5, true, cache), nodes);
+
+    // Shared by every thread
+    PerftCache shared(1024);
+    const MoveList moves = GenerateMovesLegal(board, board.Turn());
+    const std::vector<size_t> divided =
+        PerftParallel(board, moves, 5, true, false, 4, 2, SharedSubtreeCache{&shared});
+    size_t total = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        board.ApplyMove(moves[i]);
+        CHECK_EQ(divided[i], PerftBulk(board, 4));
+        board.UndoMove(moves[i]);
+        total += divided[i];
+    }
+    CHECK_EQ(total, nodes);
+}
@@ -0,0 +1,52 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/position.hpp>
+#include <JankChess/types.hpp>
+
+using namespace Chess;
+
+// Checks that a position mirrors the current state of a board
+void CheckEquivalent(const Position &position, const Board &board) {
+    CHECK_EQ(position.Turn(), board.Turn());
+    CHECK_EQ(position.EP(), board.EP());
+    CHECK_EQ(position.GetCastling(WHITE), board.GetCastling(WHITE));
+    CHECK_EQ(position.GetCastling(BLACK), board.GetCastling(BLACK));
+    CHECK_EQ(position.GetHash(), board.GetHash());
+    CHECK_EQ(position.Pieces(WHITE), board.Pieces(WHITE));
+    CHECK_EQ(position.Pieces(BLACK), board.Pieces(BLACK));
+    for (const auto piece : PIECES)
+        CHECK_EQ(position.Pieces(piece), board.Pieces(piece));
+    for (const auto sq : SQUARES)
+        CHECK_EQ(position.SquarePiece(sq), board.SquarePiece(sq));
+}
+
+TEST_SUITE("POSITION") {
+    TEST_CASE("CONSTRUCTOR") {
+        const std::string FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ";
+        CheckEquivalent(Position(FEN), Board(FEN));
+        CHECK_EQ(sizeof(Position), 128);
+    }
+    TEST_CASE("APPLY") {
+        Board board = Board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+        const Position position = Position(board);
+        const Hash prior_hash   = position.GetHash();
+        for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+            const Position next = position.Apply(move);
+            board.ApplyMove(move);
+            CheckEquivalent(next, board);
+            board.UndoMove(move);
+        }
+        CHECK_EQ(position.GetHash(), prior_hash);
+    }
+    TEST_CASE("CASTLING") {
+        const Position position = Position("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+        const Position next     = position.Apply(Move(E1, G1, Move::KingCastle));
+        CHECK_EQ(next.SquarePiece(G1), KING);
+        CHECK_EQ(next.SquarePiece(F1), ROOK);
+        CHECK_EQ(next.SquarePiece(H1), PIECE_NONE);
+        CHECK_EQ(next.GetCastling(WHITE), Castling::None);
+        CHECK_EQ(next.GetCastling(BLACK), Castling::Both);
+        CHECK_EQ(position.GetCastling(WHITE), Castling::Both);
+    }
+}
@@ -0,0 +1,58 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/psqt.hpp>
+
+using namespace Chess;
+
+TEST_CASE("PSQT_STARTPOS") {
+    // The starting position is symmetric, and every piece is on the board
+    const Board board = Board();
+    CHECK_EQ(board.GetPSQT(), Score{0, 0});
+    CHECK_EQ(board.GetPhase(), PHASE_MAX);
+}
+
+TEST_CASE("PSQT_MIRRORED") {
+    // Swapping colors, and mirroring the board, negates the score
+    const Board a = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    const Board b = Board("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - ");
+    CHECK_EQ(a.GetPSQT(), -b.GetPSQT());
+    CHECK_EQ(a.GetPhase(), b.GetPhase());
+}
+
+TEST_CASE("PSQT_TAPER") {
+    const Score score = Score{100, -100};
+    CHECK_EQ(Taper(score, PHASE_MAX), 100);
+    CHECK_EQ(Taper(score, 0), -100);
+    CHECK_EQ(Taper(score, PHASE_MAX / 2), 0);
+    // Promotions may raise the phase beyond the start of the game
+    CHECK_EQ(Taper(score, PHASE_MAX + 4), 100);
+}
+
+TEST_CASE("PSQT_INCREMENTAL") {
+    // Every move, and its undoing, keeps the incremental score equal to the one from scratch
+    Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+        const Score prior_score = board.GetPSQT();
+        const int prior_phase   = board.GetPhase();
+        board.ApplyMove(move);
+        CHECK_EQ(board.GetPSQT(), board.ComputePSQTFromScratch());
+        CHECK_EQ(board.GetPhase(), board.ComputePhaseFromScratch());
+        for (const auto reply : GenerateMovesLegal(board, board.Turn())) {
+            board.ApplyMove(reply);
+            CHECK_EQ(board.GetPSQT(), board.ComputePSQTFromScratch());
+            CHECK_EQ(board.GetPhase(), board.ComputePhaseFromScratch());
+            board.UndoMove(reply);
+        }
+        board.UndoMove(move);
+        CHECK_EQ(board.GetPSQT(), prior_score);
+        CHECK_EQ(board.GetPhase(), prior_phase);
+    }
+}
+
+TEST_CASE("PSQT_PROMOTION") {
+    Board board = Board("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    board.ApplyMove(Move(B7, B8, Move::QPromotion));
+    CHECK_EQ(board.GetPSQT(), board.ComputePSQTFromScratch());
+    CHECK_EQ(board.GetPhase(), PHASE_WEIGHTS[QUEEN]);
+}
@@ -0,0 +1,122 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/search.hpp>
+#include <JankChess/types.hpp>
+
+using namespace Chess;
+
+TEST_SUITE("SEARCH") {
+    TEST_CASE("MATE_IN_ONE") {
+        Searcher searcher(1);
+        const SearchResult result = searcher.Search(Board("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"), {});
+        CHECK_EQ(result.best_move, Move(A1, A8, Move::Quiet));
+        CHECK_EQ(result.score, SCORE_MATE - 1);
+        CHECK_EQ(result.pv.size(), 1);
+    }
+    TEST_CASE("MATED") {
+        // Black is mated in two regardless of defence
+        Searcher searcher(1);
+        const SearchResult result =
+            searcher.Search(Board("7k/8/6K1/8/8/8/8/5R2 b - - 0 1"), {.depth = 6});
+        CHECK(IsMateScore(result.score));
+        CHECK_LT(result.score, 0);
+    }
+    TEST_CASE("MATE_AT_HORIZON") {
+        // The mate is only found if the check upon the horizon is extended
+        Searcher searcher(1);
+        const SearchResult result =
+            searcher.Search(Board("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"), {.depth = 1});
+        CHECK_EQ(result.best_move, Move(A1, A8, Move::Quiet));
+        CHECK_EQ(result.score, SCORE_MATE - 1);
+    }
+    TEST_CASE("MATE_ON_FIFTIETH_MOVE") {
+        // The mate is the hundredth halfmove without a capture or pawn move, yet is still a mate
+        Searcher searcher(1);
+        const SearchResult result =
+            searcher.Search(Board("k7/8/1K6/8/8/8/8/7R w - - 99 100"), {.depth = 4});
+        CHECK_EQ(result.best_move, Move(H1, H8, Move::Quiet));
+        CHECK_EQ(result.score, SCORE_MATE - 1);
+    }
+    TEST_CASE("WINS_MATERIAL") {
+        // The queen on d5 is defended by nothing
+        Searcher searcher(1);
+        const SearchResult result =
+            searcher.Search(Board("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1"), {.depth = 4});
+        CHECK_EQ(result.best_move, Move(D2, D5, Move::Capture));
+        CHECK_GT(result.score, 300);
+    }
+    TEST_CASE("LONG_GAME") {
+        // A game longer than the history kept by the board is searched as any other
+        std::string moves;
+        for (int i = 0; i < 100; i++)
+            moves += "g1f3 g8f6 f3g1 f6g8 ";
+        Searcher searcher(1);
+        const Board board = Board("4k1n1/4p3/8/3q4/8/8/3RP3/4K1N1 w - - 0 1", moves + "e2e3 e7e5");
+        const SearchResult result = searcher.Search(board, {.depth = 4});
+        CHECK_EQ(result.best_move, Move(D2, D5, Move::Capture));
+    }
+    TEST_CASE("PV_IS_LEGAL") {
+        Searcher searcher(1);
+        Board board =
+            Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+        const SearchResult result = searcher.Search(board, {.depth = 5});
+        CHECK_EQ(result.depth, 5);
+        REQUIRE_FALSE(result.pv.empty());
+        CHECK_EQ(result.pv[0], result.best_move);
+        for (const auto move : result.pv) {
+            CHECK(GenerateMovesLegal(board, board.Turn()).contains(move));
+            board.ApplyMove(move);
+        }
+    }
+    TEST_CASE("NODE_LIMIT") {
+        Searcher searcher(1);
+        const Board board         = Board();
+        const SearchResult result = searcher.Search(board, {.nodes = 5000});
+        CHECK_LE(result.nodes, 5000);
+        CHECK(GenerateMovesLegal(board, WHITE).contains(result.best_move));
+    }
+    TEST_CASE("ITERATIONS") {
+        Searcher searcher(1);
+        int iterations = 0;
+        searcher.Search(Board(), {.depth = 4}, [&](const SearchResult &result) {
+            CHECK_EQ(result.depth, ++iterations);
+        });
+        CHECK_EQ(iterations, 4);
+    }
+    TEST_CASE("THREADS") {
+        Searcher searcher(1, 3);
+        const SearchResult result =
+            searcher.Search(Board("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1"), {.depth = 5});
+        CHECK_EQ(result.best_move, Move(D2, D5, Move::Capture));
+        REQUIRE_EQ(result.thread_nodes.size(), 3);
+        size_t nodes = 0;
+        for (const auto count : result.thread_nodes)
+            nodes += count;
+        CHECK_EQ(nodes, result.nodes);
+    }
+    TEST_CASE("THREADS_NODE_LIMIT") {
+        Searcher searcher(1, 4);
+        const SearchResult result = searcher.Search(Board(), {.nodes = 10000});
+        CHECK_LE(result.nodes, 10000);
+    }
+    TEST_CASE("TRANSPOSITION_TABLE") {
+        TranspositionTable tt(1);
+        const Hash hash = 0x123456789abcdef;
+        const Move move = Move(E2, E4, Move::DoublePawnPush);
+        CHECK_FALSE(tt.Probe(hash).has_value());
+        tt.Store(hash, move, -SCORE_MATE + 3, 7, Bound::Upper);
+        auto entry = tt.Probe(hash);
+        REQUIRE(entry.has_value());
+        CHECK_EQ(entry->move, move);
+        CHECK_EQ(entry->score, -SCORE_MATE + 3);
+        CHECK_EQ(entry->depth, 7);
+        CHECK_EQ(entry->bound, Bound::Upper);
+        // Storing without a move keeps the prior one
+        tt.Store(hash, Move(), 5, 8, Bound::Exact);
+        CHECK_EQ(tt.Probe(hash)->move, move);
+        CHECK_FALSE(tt.Probe(hash ^ 1).has_value());
+        tt.Clear();
+        CHECK_FALSE(tt.Probe(hash).has_value());
+    }
+}
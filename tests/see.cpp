@@ -0,0 +1,100 @@
+#include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
+#include <JankChess/move_picker.hpp>
+#include <JankChess/see.hpp>
+#include <JankChess/types.hpp>
+
+using namespace Chess;
+
+TEST_SUITE("SEE") {
+    TEST_CASE("ATTACKERS_TO") {
+        // d5 is attacked by pawns, knights, a bishop and a rook of either color, and the queen
+        // behind the bishop only once the bishop has moved
+        const Board board = Board("3rk3/8/2p2n2/8/4PN2/1B6/Q7/4K3 w - - 0 1");
+        const BB white    = ToBB(E4) | ToBB(F4) | ToBB(B3);
+        const BB black    = ToBB(C6) | ToBB(F6) | ToBB(D8);
+        CHECK_EQ(board.AttackersTo(D5), white | black);
+        const BB occ = board.Pieces() ^ B3;
+        CHECK_EQ(board.AttackersTo(D5, occ) & occ, (white ^ B3) | black | ToBB(A2));
+        CHECK_EQ(board.AttackersTo(E1), 0);
+    }
+    TEST_CASE("ATTACKERS_MATCH_GENERATE_ATTACKS") {
+        // A square is attacked by a color exactly when it has an attacker of that color
+        const Board board =
+            Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+        for (const auto color : {WHITE, BLACK}) {
+            const BB attacks = board.GenerateAttacks(color);
+            for (const auto sq : SQUARES)
+                CHECK_EQ(
+                    static_cast<bool>(attacks & sq),
+                    static_cast<bool>(board.AttackersTo(sq) & board.Pieces(color))
+                );
+        }
+    }
+    TEST_CASE("UNDEFENDED") {
+        const Board board = Board("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+        CHECK_EQ(SEE(board, Move(D1, D5, Move::Capture)), SEE_VALUES[QUEEN]);
+    }
+    TEST_CASE("DEFENDED") {
+        // The pawn is defended by a pawn, so the rook is lost for it
+        const Board board = Board("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1");
+        CHECK_EQ(SEE(board, Move(D1, D5, Move::Capture)), SEE_VALUES[PAWN] - SEE_VALUES[ROOK]);
+    }
+    TEST_CASE("XRAY") {
+        // The rook behind the first joins the exchange once the first has captured
+        const Board board = Board("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R2R w - - 0 1");
+        CHECK_EQ(SEE(board, Move(E1, E5, Move::Capture)), SEE_VALUES[PAWN]);
+        // The queen behind the bishop recaptures last, such that white ought not start at all
+        const Board defended = Board("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+        const int expected   = SEE_VALUES[PAWN] - SEE_VALUES[KNIGHT];
+        CHECK_EQ(SEE(defended, Move(D3, E5, Move::Capture)), expected);
+    }
+    TEST_CASE("LOSING") {
+        // Taking the knight with the queen loses the queen to the pawn
+        const Board board = Board("4k3/8/4p3/3n4/8/8/8/3QK3 w - - 0 1");
+        CHECK_EQ(SEE(board, Move(D1, D5, Move::Capture)), SEE_VALUES[KNIGHT] - SEE_VALUES[QUEEN]);
+    }
+    TEST_CASE("DECLINED_RECAPTURE") {
+        // Recapturing the rook with the queen would lose the queen to the pawn, so it is declined
+        const Board board = Board("3qk3/8/8/3n4/4P3/8/8/3RK3 w - - 0 1");
+        CHECK_EQ(SEE(board, Move(D1, D5, Move::Capture)), SEE_VALUES[KNIGHT]);
+    }
+    TEST_CASE("KING") {
+        // The king may only recapture on a square which is no longer defended
+        const Board undefended = Board("8/8/8/8/8/4k3/3p4/2Q4K w - - 0 1");
+        CHECK_EQ(
+            SEE(undefended, Move(C1, D2, Move::Capture)), SEE_VALUES[PAWN] - SEE_VALUES[QUEEN]
+        );
+        const Board defended = Board("8/8/8/8/8/4k3/3p4/2Q1K3 w - - 0 1");
+        CHECK_EQ(SEE(defended, Move(C1, D2, Move::Capture)), SEE_VALUES[PAWN]);
+    }
+    TEST_CASE("EN_PASSANT") {
+        const Board board = Board("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+        CHECK_EQ(SEE(board, Move(E5, D6, Move::EPCapture)), SEE_VALUES[PAWN]);
+    }
+    TEST_CASE("PROMOTION") {
+        const Board board = Board("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+        CHECK_EQ(
+            SEE(board, Move(A7, B8, Move::QPromotionCapture)),
+            SEE_VALUES[ROOK] + SEE_VALUES[QUEEN] - SEE_VALUES[PAWN]
+        );
+        // Promoting onto a defended square loses the pawn
+        CHECK_EQ(SEE(board, Move(A7, A8, Move::QPromotion)), -SEE_VALUES[PAWN]);
+    }
+    TEST_CASE("PICKER_DEFERS_LOSING_CAPTURES") {
+        // Taking the defended pawn with the rook loses material, so comes after every quiet move,
+        // and is not yielded at all by the tactical picker
+        const Board board = Board("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1");
+        const Move losing = Move(D1, D5, Move::Capture);
+        MoveList picked;
+        MovePicker picker(board);
+        for (Move move = picker.Next(); !(move == Move()); move = picker.Next())
+            picked << move;
+        CHECK_EQ(picked.size(), GenerateMovesAll(board, WHITE).size());
+        CHECK_EQ(picked[picked.size() - 1], losing);
+
+        MovePicker tactical = MovePicker::Tactical(board);
+        CHECK_EQ(tactical.Next(), Move());
+    }
+}
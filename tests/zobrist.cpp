@@ -1,4 +1,6 @@
 #include "third_party/doctest.h"
+#include <JankChess/board.hpp>
+#include <JankChess/move_gen.hpp>
 #include <JankChess/types.hpp>
 #include <JankChess/zobrist.hpp>
 #include <unordered_set>
@@ -11,3 +13,46 @@ TEST_CASE("ZOBRIST_ALL_UNIQUE") {
         hashes.emplace(HASHES[i]);
     CHECK_EQ(hashes.size(), HASH_COUNT);
 }
+
+TEST_CASE("ZOBRIST_TRANSPOSITION") {
+    const std::string FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const Board a         = Board(FEN, "g1f3 g8f6 b1c3");
+    const Board b         = Board(FEN, "b1c3 g8f6 g1f3");
+    CHECK_EQ(a.GetHash(), b.GetHash());
+    CHECK_EQ(a.GetHash(), a.ComputeHashFromScratch());
+}
+
+TEST_CASE("ZOBRIST_CASTLING") {
+    // Same placement of pieces, however, white has lost its castling rights by moving the king
+    const Board a = Board("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1");
+    const Board b = Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1f1 e8f8 f1e1 f8e8");
+    CHECK_EQ(b.GetCastling(WHITE), Castling::None);
+    CHECK_EQ(b.GetCastling(BLACK), Castling::None);
+    CHECK_NE(a.GetHash(), b.GetHash());
+    CHECK_EQ(b.GetHash(), b.ComputeHashFromScratch());
+    CHECK_EQ(b.GetHash(), Board("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1").GetHash());
+}
+
+TEST_CASE("ZOBRIST_TURN") {
+    CHECK_NE(
+        Board("4k3/8/8/8/8/8/8/4K3 w - - 0 1").GetHash(),
+        Board("4k3/8/8/8/8/8/8/4K3 b - - 0 1").GetHash()
+    );
+}
+
+TEST_CASE("ZOBRIST_INCREMENTAL") {
+    // Every move, and its undoing, keeps the incremental hash equal to the one from scratch
+    Board board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    for (const auto move : GenerateMovesLegal(board, board.Turn())) {
+        const Hash prior_hash = board.GetHash();
+        board.ApplyMove(move);
+        CHECK_EQ(board.GetHash(), board.ComputeHashFromScratch());
+        for (const auto reply : GenerateMovesLegal(board, board.Turn())) {
+            board.ApplyMove(reply);
+            CHECK_EQ(board.GetHash(), board.ComputeHashFromScratch());
+            board.UndoMove(reply);
+        }
+        board.UndoMove(move);
+        CHECK_EQ(board.GetHash(), prior_hash);
+    }
+}